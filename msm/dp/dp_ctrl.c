@@ -8,6 +8,7 @@
 #include <linux/types.h>
 #include <linux/completion.h>
 #include <linux/delay.h>
+#include <linux/crc32.h>
 #include <drm/drm_fixed.h>
 
 #include "dp_ctrl.h"
@@ -41,6 +42,8 @@
 #define MR_LINK_CUSTOM80 0x200
 #define MR_LINK_TRAINING4  0x40
 
+#define DP_CTRL_TRAIN_CACHE_SIZE	4
+
 struct dp_mst_ch_slot_info {
 	u32 start_slot;
 	u32 tot_slots;
@@ -50,6 +53,24 @@ struct dp_mst_channel_info {
 	struct dp_mst_ch_slot_info slot_info[DP_STREAM_MAX];
 };
 
+/**
+ * struct dp_ctrl_train_entry - last successful training result of a sink
+ * @sink_id: crc32 of the sink DPCD capabilities and base EDID block
+ * @bw_code: link rate the sink last trained at
+ * @lane_count: lane count the sink last trained at
+ * @v_level: voltage swing level at the end of training
+ * @p_level: pre-emphasis level at the end of training
+ * @valid: true if the entry holds a result
+ */
+struct dp_ctrl_train_entry {
+	u32 sink_id;
+	u32 bw_code;
+	u32 lane_count;
+	u32 v_level;
+	u32 p_level;
+	bool valid;
+};
+
 struct dp_ctrl_private {
 	struct dp_ctrl dp_ctrl;
 
@@ -75,6 +96,10 @@ struct dp_ctrl_private {
 	u32 vic;
 	u32 stream_count;
 	struct dp_mst_channel_info mst_ch_info;
+
+	struct dp_ctrl_train_entry train_cache[DP_CTRL_TRAIN_CACHE_SIZE];
+	struct dp_ctrl_train_entry *train_entry;
+	u32 train_cache_next;
 };
 
 enum notification_status {
@@ -454,9 +479,17 @@ static int dp_ctrl_link_train(struct dp_ctrl_private *ctrl)
 	int ret = 0;
 	u8 encoding = 0x1;
 	struct drm_dp_link link_info = {0};
+	struct dp_ctrl_train_entry *entry = ctrl->train_entry;
 
-	ctrl->link->phy_params.p_level = 0;
-	ctrl->link->phy_params.v_level = 0;
+	/* start from the levels the sink last trained at, if known */
+	if (entry && entry->bw_code == ctrl->link->link_params.bw_code &&
+	    entry->lane_count == ctrl->link->link_params.lane_count) {
+		ctrl->link->phy_params.p_level = entry->p_level;
+		ctrl->link->phy_params.v_level = entry->v_level;
+	} else {
+		ctrl->link->phy_params.p_level = 0;
+		ctrl->link->phy_params.v_level = 0;
+	}
 
 	link_info.num_lanes = ctrl->link->link_params.lane_count;
 	link_info.rate = drm_dp_bw_code_to_link_rate(
@@ -568,25 +601,121 @@ static void dp_ctrl_disable_link_clock(struct dp_ctrl_private *ctrl)
 	ctrl->power->clk_enable(ctrl->power, DP_LINK_PM, false);
 }
 
-static int dp_ctrl_link_setup(struct dp_ctrl_private *ctrl, bool shallow)
+static u32 dp_ctrl_get_sink_id(struct dp_ctrl_private *ctrl)
 {
-	int rc = -EINVAL;
-	u32 link_train_max_retries = 100;
-	struct dp_catalog_ctrl *catalog;
-	struct dp_link_params *link_params;
+	struct sde_edid_ctrl *edid_ctrl = ctrl->panel->edid_ctrl;
+	u32 id;
 
-	catalog = ctrl->catalog;
-	link_params = &ctrl->link->link_params;
+	id = crc32_le(~0, ctrl->panel->dpcd, DP_RECEIVER_CAP_SIZE);
+
+	if (edid_ctrl && edid_ctrl->edid)
+		id = crc32_le(id, (u8 *)edid_ctrl->edid, sizeof(struct edid));
+
+	return id;
+}
+
+/*
+ * Find the last training result of the sink. Training always starts at the
+ * maximum link; the cached drive levels are used there if the sink last
+ * trained at the maximum. Otherwise a failure at the maximum goes straight
+ * to the cached link instead of stepping down one rate at a time.
+ */
+static void dp_ctrl_train_cache_lookup(struct dp_ctrl_private *ctrl)
+{
+	struct dp_link_params *link_params = &ctrl->link->link_params;
+	struct dp_ctrl_train_entry *entry;
+	u32 sink_id, i;
+
+	ctrl->train_entry = NULL;
+	sink_id = dp_ctrl_get_sink_id(ctrl);
+
+	for (i = 0; i < DP_CTRL_TRAIN_CACHE_SIZE; i++) {
+		entry = &ctrl->train_cache[i];
+
+		if (!entry->valid || entry->sink_id != sink_id)
+			continue;
+
+		/* never go beyond what the sink reports now */
+		if (entry->lane_count > link_params->lane_count ||
+		    entry->bw_code > link_params->bw_code)
+			break;
+
+		pr_debug("sink 0x%x: cached bw_code=%d, lanes=%d, v=%d, p=%d\n",
+			sink_id, entry->bw_code, entry->lane_count,
+			entry->v_level, entry->p_level);
+
+		ctrl->train_entry = entry;
+		break;
+	}
+}
+
+static void dp_ctrl_train_cache_update(struct dp_ctrl_private *ctrl)
+{
+	struct dp_link_params *link_params = &ctrl->link->link_params;
+	struct dp_ctrl_train_entry *entry = ctrl->train_entry;
+	u32 sink_id, i;
+
+	if (!entry) {
+		sink_id = dp_ctrl_get_sink_id(ctrl);
+
+		for (i = 0; i < DP_CTRL_TRAIN_CACHE_SIZE; i++) {
+			if (ctrl->train_cache[i].valid &&
+			    ctrl->train_cache[i].sink_id == sink_id) {
+				entry = &ctrl->train_cache[i];
+				break;
+			}
+		}
+
+		if (!entry) {
+			entry = &ctrl->train_cache[ctrl->train_cache_next];
+			ctrl->train_cache_next = (ctrl->train_cache_next + 1) %
+				DP_CTRL_TRAIN_CACHE_SIZE;
+		}
+
+		entry->sink_id = sink_id;
+	}
+
+	entry->bw_code = link_params->bw_code;
+	entry->lane_count = link_params->lane_count;
+	entry->v_level = ctrl->link->phy_params.v_level;
+	entry->p_level = ctrl->link->phy_params.p_level;
+	entry->valid = true;
+
+	ctrl->train_entry = entry;
+}
+
+static void dp_ctrl_phy_lane_cfg(struct dp_ctrl_private *ctrl)
+{
+	struct dp_catalog_ctrl *catalog = ctrl->catalog;
 
 	catalog->phy_lane_cfg(catalog, ctrl->orientation,
-			link_params->lane_count);
+			ctrl->link->link_params.lane_count);
 	/*
 	 * Make sure set_phy_bond_mode is done after phy_lane_cfg.
 	 * Otherwise the spare register would be overwritten.
 	 */
 	catalog->set_phy_bond_mode(catalog, ctrl->phy_bond_mode);
+}
+
+static int dp_ctrl_link_setup(struct dp_ctrl_private *ctrl, bool shallow)
+{
+	int rc = -EINVAL;
+	u32 link_train_max_retries = 100;
+	u32 max_bw_code, max_lanes;
+	bool retrain_max = false, lane_cfg;
+	struct dp_ctrl_train_entry *entry;
+	struct dp_link_params *link_params;
+
+	link_params = &ctrl->link->link_params;
+	max_bw_code = link_params->bw_code;
+	max_lanes = link_params->lane_count;
+
+	dp_ctrl_phy_lane_cfg(ctrl);
 
 	do {
+		retrain_max = false;
+		lane_cfg = false;
+
 		pr_debug("bw_code=%d, lane_count=%d\n",
 			link_params->bw_code, link_params->lane_count);
 
@@ -597,8 +726,12 @@ static int dp_ctrl_link_setup(struct dp_ctrl_private *ctrl, bool shallow)
 		dp_ctrl_configure_source_link_params(ctrl, true);
 
 		rc = dp_ctrl_setup_main_link(ctrl);
-		if (!rc)
+		if (!rc) {
+			if (!(ctrl->link->sink_request &
+					DP_TEST_LINK_PHY_TEST_PATTERN))
+				dp_ctrl_train_cache_update(ctrl);
 			break;
+		}
 
 		/*
 		 * Shallow means link training failure is not important.
@@ -612,14 +745,45 @@ static int dp_ctrl_link_setup(struct dp_ctrl_private *ctrl, bool shallow)
 			break;
 		}
 
-		dp_ctrl_link_rate_down_shift(ctrl);
+		entry = ctrl->train_entry;
+		if (entry && entry->bw_code == link_params->bw_code &&
+		    entry->lane_count == link_params->lane_count) {
+			/*
+			 * A stale cached result is dropped. At the maximum
+			 * link, training is retried there from the default
+			 * drive levels, and this retry does not count against
+			 * link_train_max_retries.
+			 */
+			pr_debug("cached link params failed\n");
+			entry->valid = false;
+			ctrl->train_entry = NULL;
+
+			if (link_params->bw_code == max_bw_code &&
+			    link_params->lane_count == max_lanes)
+				retrain_max = true;
+			else
+				dp_ctrl_link_rate_down_shift(ctrl);
+		} else if (entry) {
+			/* skip straight to the link the sink last trained at */
+			pr_debug("max link failed, use cached bw_code=%d\n",
+				entry->bw_code);
+			link_params->bw_code = entry->bw_code;
+			lane_cfg = entry->lane_count != link_params->lane_count;
+			link_params->lane_count = entry->lane_count;
+		} else {
+			dp_ctrl_link_rate_down_shift(ctrl);
+		}
 
 		dp_ctrl_configure_source_link_params(ctrl, false);
 		dp_ctrl_disable_link_clock(ctrl);
 
+		if (lane_cfg)
+			dp_ctrl_phy_lane_cfg(ctrl);
+
 		/* hw recommended delays before retrying link training */
 		msleep(20);
-	} while (--link_train_max_retries && !atomic_read(&ctrl->aborted));
+	} while ((retrain_max || --link_train_max_retries) &&
+			!atomic_read(&ctrl->aborted));
 
 	return rc;
 }
@@ -1189,6 +1353,7 @@ static int dp_ctrl_on(struct dp_ctrl *dp_ctrl, bool mst_mode,
 			drm_dp_link_rate_to_bw_code(rate);
 		ctrl->link->link_params.lane_count =
 			ctrl->panel->link_info.num_lanes;
+		dp_ctrl_train_cache_lookup(ctrl);
 	}
 
 	pr_debug("bw_code=%d, lane_count=%d\n",
@@ -1227,6 +1392,7 @@ static void dp_ctrl_off(struct dp_ctrl *dp_ctrl)
 	ctrl->mst_mode = false;
 	ctrl->fec_mode = false;
 	ctrl->power_on = false;
+	ctrl->train_entry = NULL;
 	memset(&ctrl->mst_ch_info, 0, sizeof(ctrl->mst_ch_info));
 	pr_debug("DP off done\n");
 }
@@ -18,17 +18,14 @@
 #include <linux/slab.h>
 #include <linux/uaccess.h>
 #include <linux/debugfs.h>
+#include <linux/radix-tree.h>
 #include <drm/drm_edid.h>
 #include <soc/qcom/msm_dp_aux_bridge.h>
 #include <soc/qcom/msm_dp_mst_sim_helper.h>
 
-struct dp_sim_dpcd_reg {
-	struct list_head head;
-	u32 addr;
-	u8 val;
-};
-
 #define MAX_BUILTIN_DPCD_ADDR SZ_2K
+#define DPCD_PAGE_SHIFT 8
+#define DPCD_PAGE_SIZE BIT(DPCD_PAGE_SHIFT)
 #define MAX_MST_PORT 8
 
 struct dp_sim_device {
@@ -44,7 +41,7 @@ struct dp_sim_device {
 	struct dentry *debugfs_edid_dir;
 
 	u8 dpcd_reg[MAX_BUILTIN_DPCD_ADDR];
-	struct list_head dpcd_reg_list;
+	struct radix_tree_root dpcd_pages;
 	u32 dpcd_write_addr;
 	u32 dpcd_write_size;
 
@@ -122,69 +119,117 @@ static int dp_sim_register_hpd(struct msm_dp_aux_bridge *bridge,
 	return 0;
 }
 
+/*
+ * DPCD beyond the builtin range is kept in 256-byte pages indexed by
+ * address >> DPCD_PAGE_SHIFT. Pages are allocated on first write and
+ * unwritten addresses read back as zero.
+ */
+static u8 *dp_sim_get_dpcd_page(struct dp_sim_device *sim_dev,
+		u32 addr, bool alloc)
+{
+	unsigned long index = addr >> DPCD_PAGE_SHIFT;
+	u8 *page;
+
+	page = radix_tree_lookup(&sim_dev->dpcd_pages, index);
+	if (page || !alloc)
+		return page;
+
+	page = kzalloc(DPCD_PAGE_SIZE, GFP_KERNEL);
+	if (!page)
+		return NULL;
+
+	if (radix_tree_insert(&sim_dev->dpcd_pages, index, page)) {
+		kfree(page);
+		return NULL;
+	}
+
+	return page;
+}
+
+static void dp_sim_free_dpcd_pages(struct dp_sim_device *sim_dev)
+{
+	struct radix_tree_iter iter;
+	void __rcu **slot;
+
+	radix_tree_for_each_slot(slot, &sim_dev->dpcd_pages, &iter, 0) {
+		kfree(radix_tree_deref_slot(slot));
+		radix_tree_iter_delete(&sim_dev->dpcd_pages, &iter, slot);
+	}
+}
+
 static int dp_sim_read_dpcd(struct dp_sim_device *sim_dev,
 		struct drm_dp_aux_msg *msg)
 {
-	struct dp_sim_dpcd_reg *reg;
-	u32 i, addr;
-	u8 *buf;
-
-	if (msg->address + msg->size <= MAX_BUILTIN_DPCD_ADDR) {
-		memcpy(msg->buffer,
-			&sim_dev->dpcd_reg[msg->address],
-			msg->size);
-	} else {
-		buf = (u8 *)msg->buffer;
-		for (i = 0; i < msg->size; i++) {
-			addr = msg->address + i;
-			if (addr < MAX_BUILTIN_DPCD_ADDR)
-				buf[i] = sim_dev->dpcd_reg[addr];
-			else {
-				buf[i] = 0;
-				list_for_each_entry(reg,
-						&sim_dev->dpcd_reg_list,
-						head) {
-					if (reg->addr == addr) {
-						buf[i] = reg->val;
-						break;
-					}
-				}
-			}
-		}
+	u32 addr = msg->address, len;
+	u8 *buf = msg->buffer;
+	size_t size = msg->size;
+	u8 *page;
+
+	if (addr < MAX_BUILTIN_DPCD_ADDR) {
+		len = min_t(size_t, size, MAX_BUILTIN_DPCD_ADDR - addr);
+		memcpy(buf, &sim_dev->dpcd_reg[addr], len);
+		buf += len;
+		addr += len;
+		size -= len;
+	}
+
+	while (size) {
+		len = min_t(size_t, size,
+			DPCD_PAGE_SIZE - (addr & (DPCD_PAGE_SIZE - 1)));
+
+		page = dp_sim_get_dpcd_page(sim_dev, addr, false);
+		if (page)
+			memcpy(buf, &page[addr & (DPCD_PAGE_SIZE - 1)], len);
+		else
+			memset(buf, 0, len);
+
+		buf += len;
+		addr += len;
+		size -= len;
 	}
 
 	return msg->size;
 }
 
-static int dp_sim_write_dpcd(struct dp_sim_device *sim_dev,
-		u32 addr, u8 val)
+static int dp_sim_write_dpcd_buf(struct dp_sim_device *sim_dev,
+		u32 addr, const u8 *buf, size_t size)
 {
-	struct dp_sim_dpcd_reg *dpcd_reg;
+	u32 len;
+	u8 *page;
 
 	if (addr < MAX_BUILTIN_DPCD_ADDR) {
-		sim_dev->dpcd_reg[addr] = val;
-	} else {
-		list_for_each_entry(dpcd_reg, &sim_dev->dpcd_reg_list, head) {
-			if (dpcd_reg->addr == addr) {
-				dpcd_reg->val = val;
-				return 0;
-			}
-		}
+		len = min_t(size_t, size, MAX_BUILTIN_DPCD_ADDR - addr);
+		memcpy(&sim_dev->dpcd_reg[addr], buf, len);
+		buf += len;
+		addr += len;
+		size -= len;
+	}
 
-		dpcd_reg = devm_kzalloc(&sim_dev->pdev->dev,
-				sizeof(*dpcd_reg), GFP_KERNEL);
-		if (!dpcd_reg)
+	while (size) {
+		len = min_t(size_t, size,
+			DPCD_PAGE_SIZE - (addr & (DPCD_PAGE_SIZE - 1)));
+
+		page = dp_sim_get_dpcd_page(sim_dev, addr, true);
+		if (!page)
 			return -ENOMEM;
 
-		dpcd_reg->addr = addr;
-		dpcd_reg->val = val;
-		list_add_tail(&dpcd_reg->head, &sim_dev->dpcd_reg_list);
+		memcpy(&page[addr & (DPCD_PAGE_SIZE - 1)], buf, len);
+
+		buf += len;
+		addr += len;
+		size -= len;
 	}
 
-	pr_debug("dpcd[0x%x]=0x%x\n", addr, val);
 	return 0;
 }
 
+static int dp_sim_write_dpcd(struct dp_sim_device *sim_dev,
+		u32 addr, u8 val)
+{
+	pr_debug("dpcd[0x%x]=0x%x\n", addr, val);
+	return dp_sim_write_dpcd_buf(sim_dev, addr, &val, 1);
+}
+
 static int dp_sim_read_edid(struct dp_sim_device *sim_dev,
 		struct drm_dp_aux_msg *msg)
 {
@@ -781,6 +826,7 @@ static ssize_t dp_sim_debug_write_dpcd(struct file *file,
 	if (offset == 0xFFFF) {
 		pr_err("clearing dpcd\n");
 		memset(debug->dpcd_reg, 0, sizeof(debug->dpcd_reg));
+		dp_sim_free_dpcd_pages(debug);
 		goto bail;
 	}
 
@@ -1339,7 +1385,7 @@ static int dp_sim_probe(struct platform_device *pdev)
 	dp_sim_dev->bridge.transfer = dp_sim_transfer;
 	dp_sim_dev->bridge.dev_priv = dp_sim_dev;
 	dp_sim_dev->bridge.flag = MSM_DP_AUX_BRIDGE_MST;
-	INIT_LIST_HEAD(&dp_sim_dev->dpcd_reg_list);
+	INIT_RADIX_TREE(&dp_sim_dev->dpcd_pages, GFP_KERNEL);
 	mutex_init(&dp_sim_dev->lock);
 
 	memset(&cfg, 0, sizeof(cfg));
@@ -1378,6 +1424,7 @@ static int dp_sim_probe(struct platform_device *pdev)
 
 fail:
 	msm_dp_mst_sim_destroy(dp_sim_dev->bridge.mst_ctx);
+	dp_sim_free_dpcd_pages(dp_sim_dev);
 	return ret;
 }
 
@@ -1393,6 +1440,8 @@ static int dp_sim_remove(struct platform_device *pdev)
 
 	debugfs_remove_recursive(dp_sim_dev->debugfs_dir);
 
+	dp_sim_free_dpcd_pages(dp_sim_dev);
+
 	return 0;
 }
 
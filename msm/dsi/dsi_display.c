@@ -9,6 +9,7 @@
 #include <linux/of.h>
 #include <linux/of_gpio.h>
 #include <linux/err.h>
+#include <linux/jhash.h>
 
 #include "msm_drv.h"
 #include "sde_connector.h"
@@ -5455,6 +5456,8 @@ int dsi_display_dev_remove(struct platform_device *pdev)
 
 	(void)_dsi_display_dev_deinit(display);
 
+	dsi_display_free_modes(display);
+
 	platform_set_drvdata(pdev, NULL);
 	devm_kfree(&pdev->dev, display);
 	return rc;
@@ -6197,6 +6200,84 @@ void dsi_display_put_mode(struct dsi_display *display,
 	dsi_panel_put_mode(mode);
 }
 
+static u32 _dsi_display_mode_hash_key(const struct dsi_display_mode *mode)
+{
+	return jhash_3words(mode->timing.v_active, mode->timing.h_active,
+			mode->timing.refresh_rate ^ (mode->pixel_clk_khz << 8),
+			0);
+}
+
+static bool _dsi_display_mode_match(const struct dsi_display_mode *a,
+		const struct dsi_display_mode *b)
+{
+	return a->timing.v_active == b->timing.v_active &&
+		a->timing.h_active == b->timing.h_active &&
+		a->timing.refresh_rate == b->timing.refresh_rate &&
+		a->pixel_clk_khz == b->pixel_clk_khz;
+}
+
+/*
+ * Build the mode hash once the mode array is final, with display_lock
+ * held. Modes are added in reverse so that the first match in a bucket is
+ * the lowest index, the same mode the linear search returns. The index is
+ * published to dsi_display_find_mode by the rcu_assign_pointer of
+ * mode_nodes, after which neither the hash nor the modes change until
+ * _dsi_display_free_modes. Without an index, lookups fall back to a locked
+ * linear search.
+ */
+static void _dsi_display_build_mode_hash(struct dsi_display *display,
+		u32 count)
+{
+	struct dsi_display_mode_node *nodes;
+	int i;
+
+	nodes = kcalloc(count, sizeof(*nodes), GFP_KERNEL);
+	if (!nodes)
+		return;
+
+	hash_init(display->mode_hash);
+
+	for (i = count - 1; i >= 0; i--) {
+		nodes[i].mode = &display->modes[i];
+		hash_add_rcu(display->mode_hash, &nodes[i].hnode,
+				_dsi_display_mode_hash_key(nodes[i].mode));
+	}
+
+	rcu_assign_pointer(display->mode_nodes, nodes);
+}
+
+/*
+ * Free the probed modes and their hash index, with display_lock held. The
+ * index is unpublished first and freed only once lock-free readers in
+ * dsi_display_find_mode are done with it.
+ */
+static void _dsi_display_free_modes(struct dsi_display *display)
+{
+	struct dsi_display_mode_node *nodes;
+
+	nodes = rcu_dereference_protected(display->mode_nodes,
+			lockdep_is_held(&display->display_lock));
+	if (nodes) {
+		RCU_INIT_POINTER(display->mode_nodes, NULL);
+		synchronize_rcu();
+		kfree(nodes);
+	}
+	hash_init(display->mode_hash);
+
+	kfree(display->modes);
+	display->modes = NULL;
+}
+
+void dsi_display_free_modes(struct dsi_display *display)
+{
+	if (!display)
+		return;
+
+	mutex_lock(&display->display_lock);
+	_dsi_display_free_modes(display);
+	mutex_unlock(&display->display_lock);
+}
+
 int dsi_display_get_modes(struct dsi_display *display,
 			  struct dsi_display_mode **out_modes)
 {
@@ -6316,13 +6397,15 @@ int dsi_display_get_modes(struct dsi_display *display,
 		_dsi_display_populate_bit_clks(display, start, end, &array_idx);
 	}
 
+	_dsi_display_build_mode_hash(display, total_mode_count);
+
 exit:
 	*out_modes = display->modes;
 	rc = 0;
 
 error:
 	if (rc)
-		kfree(display->modes);
+		_dsi_display_free_modes(display);
 
 	mutex_unlock(&display->display_lock);
 	return rc;
@@ -6404,20 +6487,32 @@ int dsi_display_find_mode(struct dsi_display *display,
 			return rc;
 	}
 
-	mutex_lock(&display->display_lock);
-	for (i = 0; i < count; i++) {
-		struct dsi_display_mode *m = &display->modes[i];
+	rcu_read_lock();
+	if (rcu_dereference(display->mode_nodes)) {
+		struct dsi_display_mode_node *node;
 
-		if (cmp->timing.v_active == m->timing.v_active &&
-			cmp->timing.h_active == m->timing.h_active &&
-			cmp->timing.refresh_rate == m->timing.refresh_rate &&
-			cmp->pixel_clk_khz == m->pixel_clk_khz) {
-			*out_mode = m;
-			rc = 0;
-			break;
+		hash_for_each_possible_rcu(display->mode_hash, node, hnode,
+				_dsi_display_mode_hash_key(cmp)) {
+			if (_dsi_display_mode_match(cmp, node->mode)) {
+				*out_mode = node->mode;
+				break;
+			}
+		}
+		rcu_read_unlock();
+	} else {
+		rcu_read_unlock();
+
+		mutex_lock(&display->display_lock);
+		for (i = 0; display->modes && i < count; i++) {
+			struct dsi_display_mode *m = &display->modes[i];
+
+			if (_dsi_display_mode_match(cmp, m)) {
+				*out_mode = m;
+				break;
+			}
 		}
+		mutex_unlock(&display->display_lock);
 	}
-	mutex_unlock(&display->display_lock);
 
 	if (!*out_mode) {
 		pr_err("[%s] failed to find mode for v_active %u h_active %u fps %u pclk %u\n",
@@ -11,6 +11,7 @@
 #include <linux/debugfs.h>
 #include <linux/of_device.h>
 #include <linux/firmware.h>
+#include <linux/hashtable.h>
 #include <drm/drmP.h>
 #include <drm/drm_crtc.h>
 
@@ -23,6 +24,7 @@
 #define DSI_CLIENT_NAME_SIZE		20
 #define MAX_CMDLINE_PARAM_LEN	 512
 #define MAX_CMD_PAYLOAD_SIZE	256
+#define DSI_DISPLAY_MODE_HASH_BITS	5
 /*
  * DSI Validate Mode modifiers
  * @DSI_VALIDATE_FLAG_ALLOW_ADJUST:	Allow mode validation to also do fixup
@@ -134,6 +136,16 @@ struct dsi_display_ext_bridge {
 	struct drm_bridge_funcs bridge_funcs;
 };
 
+/**
+ * struct dsi_display_mode_node - hashed index entry of a probed mode
+ * @hnode:             Entry in the display mode hash.
+ * @mode:              Mode in the probed mode array.
+ */
+struct dsi_display_mode_node {
+	struct hlist_node hnode;
+	struct dsi_display_mode *mode;
+};
+
 /**
  * struct dsi_display - dsi display information
  * @pdev:             Pointer to platform device.
@@ -157,6 +169,8 @@ struct dsi_display_ext_bridge {
  * @panel_of:         pHandle to DSI panel.
  * @ext_bridge:       External bridge information for DSI display.
  * @modes:            Array of probed DSI modes
+ * @mode_nodes:       Hash index entries for @modes, RCU published once built
+ * @mode_hash:        Hash of @modes keyed by resolution, fps and pclk
  * @type:             DSI display type.
  * @clk_master_idx:   The master controller for controlling clocks. This is an
  *		      index into the ctrl[MAX_DSI_CTRLS_PER_DISPLAY] array.
@@ -215,6 +229,8 @@ struct dsi_display {
 	struct dsi_display_ext_bridge ext_bridge[MAX_EXT_BRIDGE_PORT_CONFIG];
 
 	struct dsi_display_mode *modes;
+	struct dsi_display_mode_node __rcu *mode_nodes;
+	DECLARE_HASHTABLE(mode_hash, DSI_DISPLAY_MODE_HASH_BITS);
 
 	enum dsi_display_type type;
 	u32 clk_master_idx;
@@ -370,6 +386,14 @@ int dsi_display_get_mode_count(struct dsi_display *display, u32 *count);
 int dsi_display_get_modes(struct dsi_display *display,
 			  struct dsi_display_mode **modes);
 
+/**
+ * dsi_display_free_modes() - free the modes returned by dsi_display_get_modes
+ * @display:            Handle to display.
+ *
+ * Frees the probed mode array together with its hash index.
+ */
+void dsi_display_free_modes(struct dsi_display *display);
+
 /**
  * dsi_display_put_mode() - free up mode created for the display
  * @display:            Handle to display.
@@ -691,8 +691,7 @@ void dsi_connector_put_modes(struct drm_connector *connector,
 
 	/* free the display structure modes also */
 	dsi_display = display;
-	kfree(dsi_display->modes);
-	dsi_display->modes = NULL;
+	dsi_display_free_modes(dsi_display);
 }
 
 
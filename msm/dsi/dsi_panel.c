@@ -12,6 +12,7 @@
 #include <video/mipi_display.h>
 
 #include "dsi_panel.h"
+#include "dsi_ctrl.h"
 #include "dsi_ctrl_hw.h"
 #include "dsi_parser.h"
 
@@ -487,6 +488,53 @@ static int dsi_panel_power_off(struct dsi_panel *panel)
 
 	return rc;
 }
+
+/*
+ * Worst case size of a command in the embedded mode DMA buffer: the
+ * 4 byte packet header plus the payload padded to a word boundary.
+ */
+static u32 dsi_panel_cmd_dma_len(const struct dsi_cmd_desc *cmd)
+{
+	return ALIGN(cmd->msg.tx_len + 4, 4);
+}
+
+static bool dsi_panel_cmd_is_embedded(const struct dsi_cmd_desc *cmd)
+{
+	return (cmd->msg.tx_len + 4) <= DSI_EMBEDDED_MODE_DMA_MAX_SIZE_BYTES;
+}
+
+/**
+ * dsi_panel_cmd_ends_batch() - check if the DMA must be triggered after cmd
+ * @cmd:	command about to be sent
+ * @next:	following command of the set, NULL if @cmd is the last one
+ * @batch_len:	bytes queued in the DMA buffer, including @cmd
+ *
+ * Commands are queued in the command DMA buffer until one of them needs
+ * to reach the panel on its own: it has a post wait or needs an ack, it
+ * is the last of the set, or the next one can't share the buffer. The
+ * per command last_command setting from the panel dt is ignored.
+ */
+static bool dsi_panel_cmd_ends_batch(const struct dsi_cmd_desc *cmd,
+		const struct dsi_cmd_desc *next, u32 batch_len)
+{
+	if (cmd->post_wait_ms || !next)
+		return true;
+
+	if (cmd->msg.flags & MIPI_DSI_MSG_REQ_ACK)
+		return true;
+
+	if (!dsi_panel_cmd_is_embedded(cmd) ||
+			!dsi_panel_cmd_is_embedded(next))
+		return true;
+
+	if ((cmd->msg.flags & MIPI_DSI_MSG_UNICAST) !=
+			(next->msg.flags & MIPI_DSI_MSG_UNICAST) ||
+			cmd->msg.ctrl != next->msg.ctrl)
+		return true;
+
+	return (batch_len + dsi_panel_cmd_dma_len(next)) > SZ_4K;
+}
+
 static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 				enum dsi_cmd_set_type type)
 {
@@ -494,6 +542,7 @@ static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 	ssize_t len;
 	struct dsi_cmd_desc *cmds;
 	u32 count;
+	u32 batch_len = 0;
 	enum dsi_cmd_set_state state;
 	struct dsi_display_mode *mode;
 	const struct mipi_dsi_host_ops *ops = panel->host->ops;
@@ -517,8 +566,18 @@ static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 		if (state == DSI_CMD_SET_STATE_LP)
 			cmds->msg.flags |= MIPI_DSI_MSG_USE_LPM;
 
-		if (cmds->last_command)
+		if (panel->cmd_batch_en) {
+			batch_len += dsi_panel_cmd_dma_len(cmds);
+			cmds->msg.flags &= ~MIPI_DSI_MSG_LASTCOMMAND;
+			if (dsi_panel_cmd_ends_batch(cmds,
+					(i + 1 < count) ? cmds + 1 : NULL,
+					batch_len)) {
+				cmds->msg.flags |= MIPI_DSI_MSG_LASTCOMMAND;
+				batch_len = 0;
+			}
+		} else if (cmds->last_command) {
 			cmds->msg.flags |= MIPI_DSI_MSG_LASTCOMMAND;
+		}
 
 		len = ops->transfer(panel->host, &cmds->msg);
 		if (len < 0) {
@@ -2066,6 +2125,9 @@ static int dsi_panel_parse_misc_features(struct dsi_panel *panel)
 
 	panel->lp11_init = utils->read_bool(utils->data,
 			"qcom,mdss-dsi-lp11-init");
+
+	panel->cmd_batch_en = utils->read_bool(utils->data,
+			"qcom,mdss-dsi-cmd-batch-enabled");
 	return 0;
 }
 
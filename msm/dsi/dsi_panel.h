@@ -202,6 +202,7 @@ struct dsi_panel {
 	enum dsi_dms_mode dms_mode;
 
 	bool sync_broadcast_en;
+	bool cmd_batch_en;
 	int power_mode;
 	enum dsi_panel_physical_type panel_type;
 };
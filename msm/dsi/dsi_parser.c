@@ -12,6 +12,9 @@
 #include <linux/debugfs.h>
 #include <linux/uaccess.h>
 #include <linux/device.h>
+#include <linux/hash.h>
+#include <linux/stringhash.h>
+#include <linux/log2.h>
 
 #include "dsi_parser.h"
 
@@ -41,6 +44,10 @@ struct dsi_parser_node {
 	struct dsi_parser_prop *prop;
 	int prop_count;
 
+	/* open addressed index of prop, entries are prop index + 1 */
+	u16 *prop_hash;
+	u32 prop_hash_bits;
+
 	struct dsi_parser_node *child[DSI_PARSER_MAX_NODES];
 	int children_count;
 };
@@ -400,6 +407,51 @@ static void dsi_parser_count_properties(struct dsi_parser_node *node)
 	}
 }
 
+static u32 dsi_parser_prop_hash(const char *name, u32 bits)
+{
+	return hash_32(full_name_hash(NULL, name, strlen(name)), bits);
+}
+
+/*
+ * Index the parsed properties of a node by name, the first property of
+ * a given name wins as with the linear search. On allocation failure the
+ * node is left without index and lookups fall back to the linear search.
+ */
+static void dsi_parser_hash_properties(struct device *dev,
+		struct dsi_parser_node *node)
+{
+	struct dsi_parser_prop *prop = node->prop;
+	u32 i, bits, mask, slot;
+	u16 entry;
+
+	if (!prop || !node->prop_count || node->prop_count >= U16_MAX)
+		return;
+
+	bits = max(ilog2(roundup_pow_of_two(node->prop_count * 2)), 1);
+	node->prop_hash = devm_kcalloc(dev, BIT(bits), sizeof(u16),
+			GFP_KERNEL);
+	if (!node->prop_hash)
+		return;
+
+	node->prop_hash_bits = bits;
+	mask = BIT(bits) - 1;
+
+	for (i = 0; i < node->prop_count; i++) {
+		if (!prop[i].name)
+			continue;
+
+		slot = dsi_parser_prop_hash(prop[i].name, bits);
+		while ((entry = node->prop_hash[slot])) {
+			if (!strcmp(prop[entry - 1].name, prop[i].name))
+				break;
+			slot = (slot + 1) & mask;
+		}
+
+		if (!entry)
+			node->prop_hash[slot] = i + 1;
+	}
+}
+
 static void dsi_parser_get_properties(struct device *dev,
 		struct dsi_parser_node *node)
 {
@@ -441,6 +493,8 @@ static void dsi_parser_get_properties(struct device *dev,
 		}
 	}
 
+	dsi_parser_hash_properties(dev, node);
+
 	for (count = 0; count < node->children_count; count++)
 		dsi_parser_get_properties(dev, node->child[count]);
 }
@@ -451,6 +505,21 @@ static struct dsi_parser_prop *dsi_parser_search_property(
 {
 	int i = 0;
 	struct dsi_parser_prop *prop = node->prop;
+	u32 mask, slot;
+	u16 entry;
+
+	if (node->prop_hash) {
+		mask = BIT(node->prop_hash_bits) - 1;
+		slot = dsi_parser_prop_hash(name, node->prop_hash_bits);
+
+		while ((entry = node->prop_hash[slot])) {
+			if (!strcmp(prop[entry - 1].name, name))
+				return &prop[entry - 1];
+			slot = (slot + 1) & mask;
+		}
+
+		return NULL;
+	}
 
 	for (i = 0; i < node->prop_count; i++) {
 		if (prop[i].name && !strcmp(prop[i].name, name))
@@ -936,6 +1005,9 @@ static void dsi_parser_free_mem(struct device *dev,
 	if (node->prop)
 		devm_kfree(dev, node->prop);
 
+	if (node->prop_hash)
+		devm_kfree(dev, node->prop_hash);
+
 	for (i = 0; i < node->children_count; i++)
 		dsi_parser_free_mem(dev, node->child[i]);
 
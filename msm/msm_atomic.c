@@ -26,6 +26,20 @@
 
 #define MULTIPLE_CONN_DETECTED(x) (x > 1)
 
+struct msm_commit;
+
+/**
+ * struct msm_commit_crtc - per-crtc portion of a multi-crtc commit
+ * @work: work item queued on the crtc's display thread
+ * @commit: parent commit
+ * @old_crtc_state: old crtc state of this crtc in the commit
+ */
+struct msm_commit_crtc {
+	struct kthread_work work;
+	struct msm_commit *commit;
+	struct drm_crtc_state *old_crtc_state;
+};
+
 struct msm_commit {
 	struct drm_device *dev;
 	struct drm_atomic_state *state;
@@ -33,6 +47,11 @@ struct msm_commit {
 	uint32_t plane_mask;
 	bool nonblock;
 	struct kthread_work commit_work;
+
+	/* join point for per-crtc plane programming */
+	atomic_t crtc_pending;
+	struct completion crtc_done;
+	struct msm_commit_crtc crtc_commits[MAX_CRTCS];
 };
 
 extern int msm_drm_notifier_call_chain(unsigned long val, void *v);
@@ -521,6 +540,115 @@ static void msm_atomic_helper_commit_modeset_enables(struct drm_device *dev,
 	SDE_ATRACE_END("msm_enable");
 }
 
+static struct msm_drm_thread *_msm_atomic_get_disp_thread(
+		struct msm_drm_private *priv, struct drm_crtc *crtc)
+{
+	int i;
+
+	for (i = 0; i < priv->num_crtcs; i++) {
+		if (priv->disp_thread[i].crtc_id == crtc->base.id)
+			return &priv->disp_thread[i];
+	}
+
+	return NULL;
+}
+
+static void _msm_atomic_commit_crtc_work_cb(struct kthread_work *work)
+{
+	struct msm_commit_crtc *crtc_commit;
+	struct msm_commit *c;
+
+	crtc_commit = container_of(work, struct msm_commit_crtc, work);
+	c = crtc_commit->commit;
+
+	SDE_ATRACE_BEGIN("commit_planes_on_crtc");
+	drm_atomic_helper_commit_planes_on_crtc(crtc_commit->old_crtc_state);
+	SDE_ATRACE_END("commit_planes_on_crtc");
+
+	if (atomic_dec_and_test(&c->crtc_pending))
+		complete(&c->crtc_done);
+}
+
+/**
+ * msm_atomic_commit_planes - program planes of all crtcs in the commit
+ * @dev: DRM device
+ * @c: commit being completed
+ *
+ * When the commit touches more than one crtc and every crtc has its own
+ * display thread, plane programming for each crtc is fanned out to that
+ * crtc's display thread, with the crtc owned by the calling thread handled
+ * inline. The function returns only once all crtcs have been programmed,
+ * so the remaining commit sequence is unchanged. Commits that move a plane
+ * between crtcs use the serial helper, as the per-crtc helper can't handle
+ * a plane owned by two crtcs.
+ */
+static void msm_atomic_commit_planes(struct drm_device *dev,
+		struct msm_commit *c)
+{
+	struct drm_atomic_state *state = c->state;
+	struct msm_drm_private *priv = dev->dev_private;
+	struct msm_drm_thread *disp_thread;
+	struct msm_commit_crtc *crtc_commit, *local = NULL;
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *old_crtc_state;
+	struct drm_plane *plane;
+	struct drm_plane_state *old_plane_state, *new_plane_state;
+	int i, crtc_cnt = 0;
+
+	for_each_oldnew_plane_in_state(state, plane, old_plane_state,
+			new_plane_state, i) {
+		if (old_plane_state->crtc && new_plane_state->crtc &&
+				old_plane_state->crtc != new_plane_state->crtc) {
+			drm_atomic_helper_commit_planes(dev, state, 0);
+			return;
+		}
+	}
+
+	for_each_old_crtc_in_state(state, crtc, old_crtc_state, i) {
+		disp_thread = _msm_atomic_get_disp_thread(priv, crtc);
+		if (!disp_thread || !disp_thread->thread) {
+			crtc_cnt = 0;
+			break;
+		}
+		crtc_cnt++;
+	}
+
+	if (crtc_cnt < 2) {
+		drm_atomic_helper_commit_planes(dev, state, 0);
+		return;
+	}
+
+	SDE_ATRACE_BEGIN("msm_commit_planes_parallel");
+	init_completion(&c->crtc_done);
+	/* hold a reference so the join can't complete while queueing */
+	atomic_set(&c->crtc_pending, 1);
+
+	for_each_old_crtc_in_state(state, crtc, old_crtc_state, i) {
+		disp_thread = _msm_atomic_get_disp_thread(priv, crtc);
+		crtc_commit = &c->crtc_commits[drm_crtc_index(crtc)];
+		crtc_commit->commit = c;
+		crtc_commit->old_crtc_state = old_crtc_state;
+
+		/* queueing on our own worker would deadlock on the join */
+		if (disp_thread->thread == current) {
+			local = crtc_commit;
+			continue;
+		}
+
+		atomic_inc(&c->crtc_pending);
+		kthread_init_work(&crtc_commit->work,
+				_msm_atomic_commit_crtc_work_cb);
+		kthread_queue_work(&disp_thread->worker, &crtc_commit->work);
+	}
+
+	if (local)
+		drm_atomic_helper_commit_planes_on_crtc(local->old_crtc_state);
+
+	if (!atomic_dec_and_test(&c->crtc_pending))
+		wait_for_completion(&c->crtc_done);
+	SDE_ATRACE_END("msm_commit_planes_parallel");
+}
+
 /* The (potentially) asynchronous part of the commit.  At this point
  * nothing can fail short of armageddon.
  */
@@ -537,7 +665,7 @@ static void complete_commit(struct msm_commit *c)
 
 	msm_atomic_helper_commit_modeset_disables(dev, state);
 
-	drm_atomic_helper_commit_planes(dev, state, 0);
+	msm_atomic_commit_planes(dev, c);
 
 	msm_atomic_helper_commit_modeset_enables(dev, state);
 
@@ -605,39 +733,33 @@ static void msm_atomic_commit_dispatch(struct drm_device *dev,
 	struct msm_drm_private *priv = dev->dev_private;
 	struct drm_crtc *crtc = NULL;
 	struct drm_crtc_state *crtc_state = NULL;
-	int ret = -EINVAL, i = 0, j = 0;
+	struct msm_drm_thread *disp_thread;
+	int ret = -EINVAL, i = 0;
 	bool nonblock;
 
 	/* cache since work will kfree commit in non-blocking case */
 	nonblock = commit->nonblock;
 
+	/*
+	 * The commit is owned by the display thread of the first crtc in the
+	 * state; plane programming of any additional crtcs is fanned out to
+	 * their own display threads from msm_atomic_commit_planes().
+	 */
 	for_each_crtc_in_state(state, crtc, crtc_state, i) {
-		for (j = 0; j < priv->num_crtcs; j++) {
-			if (priv->disp_thread[j].crtc_id ==
-						crtc->base.id) {
-				if (priv->disp_thread[j].thread) {
-					kthread_queue_work(
-						&priv->disp_thread[j].worker,
-							&commit->commit_work);
-					/* only return zero if work is
-					 * queued successfully.
-					 */
-					ret = 0;
-				} else {
-					DRM_ERROR(" Error for crtc_id: %d\n",
-						priv->disp_thread[j].crtc_id);
-				}
-				break;
-			}
+		disp_thread = _msm_atomic_get_disp_thread(priv, crtc);
+		if (!disp_thread)
+			continue;
+
+		if (disp_thread->thread) {
+			kthread_queue_work(&disp_thread->worker,
+					&commit->commit_work);
+			/* only return zero if work is queued successfully. */
+			ret = 0;
+		} else {
+			DRM_ERROR(" Error for crtc_id: %d\n",
+					disp_thread->crtc_id);
 		}
-		/*
-		 * TODO: handle cases where there will be more than
-		 * one crtc per commit cycle. Remove this check then.
-		 * Current assumption is there will be only one crtc
-		 * per commit cycle.
-		 */
-		if (j < priv->num_crtcs)
-			break;
+		break;
 	}
 
 	if (ret) {
@@ -342,6 +342,24 @@ dma_addr_t msm_gem_get_dma_addr(struct drm_gem_object *obj)
 	return sg_phys(msm_obj->sgt->sgl);
 }
 
+static struct msm_gem_vma __rcu **vma_slot(struct msm_gem_object *msm_obj,
+		struct msm_gem_address_space *aspace)
+{
+	if (!aspace || aspace->id < 0)
+		return NULL;
+
+	return &msm_obj->vma_slots[aspace->id];
+}
+
+static void vma_slot_clear(struct msm_gem_object *msm_obj,
+		struct msm_gem_vma *vma)
+{
+	struct msm_gem_vma __rcu **slot = vma_slot(msm_obj, vma->aspace);
+
+	if (slot && rcu_access_pointer(*slot) == vma)
+		RCU_INIT_POINTER(*slot, NULL);
+}
+
 static struct msm_gem_vma *add_vma(struct drm_gem_object *obj,
 		struct msm_gem_address_space *aspace)
 {
@@ -365,10 +383,16 @@ static struct msm_gem_vma *lookup_vma(struct drm_gem_object *obj,
 		struct msm_gem_address_space *aspace)
 {
 	struct msm_gem_object *msm_obj = to_msm_bo(obj);
+	struct msm_gem_vma __rcu **slot = vma_slot(msm_obj, aspace);
 	struct msm_gem_vma *vma;
 
 	WARN_ON(!mutex_is_locked(&msm_obj->lock));
 
+	/* a vma is only slotted once mapped, so an empty slot is a miss */
+	if (slot)
+		return rcu_dereference_protected(*slot,
+				mutex_is_locked(&msm_obj->lock));
+
 	list_for_each_entry(vma, &msm_obj->vmas, list) {
 		if (vma->aspace == aspace)
 			return vma;
@@ -377,13 +401,31 @@ static struct msm_gem_vma *lookup_vma(struct drm_gem_object *obj,
 	return NULL;
 }
 
-static void del_vma(struct msm_gem_vma *vma)
+/* Lockless lookup of a mapped vma, called under rcu_read_lock */
+static struct msm_gem_vma *lookup_vma_rcu(struct msm_gem_object *msm_obj,
+		struct msm_gem_address_space *aspace)
+{
+	struct msm_gem_vma __rcu **slot = vma_slot(msm_obj, aspace);
+	struct msm_gem_vma *vma;
+
+	if (!slot)
+		return NULL;
+
+	vma = rcu_dereference(*slot);
+	if (!vma || vma->aspace != aspace)
+		return NULL;
+
+	return vma;
+}
+
+static void del_vma(struct msm_gem_object *msm_obj, struct msm_gem_vma *vma)
 {
 	if (!vma)
 		return;
 
+	vma_slot_clear(msm_obj, vma);
 	list_del(&vma->list);
-	kfree(vma);
+	kfree_rcu(vma, rcu);
 }
 
 /* Called with msm_obj->lock locked */
@@ -395,6 +437,8 @@ static void put_iova(struct drm_gem_object *obj)
 	WARN_ON(!mutex_is_locked(&msm_obj->lock));
 
 	list_for_each_entry_safe(vma, tmp, &msm_obj->vmas, list) {
+		/* hide the vma from lockless readers before unmapping it */
+		vma_slot_clear(msm_obj, vma);
 		msm_gem_unmap_vma(vma->aspace, vma, msm_obj->sgt,
 				msm_obj->flags);
 		/*
@@ -403,7 +447,7 @@ static void put_iova(struct drm_gem_object *obj)
 		 * update the active_list during gem_free_obj and gem_purge.
 		 */
 		msm_obj->aspace = vma->aspace;
-		del_vma(vma);
+		del_vma(msm_obj, vma);
 	}
 }
 
@@ -415,6 +459,20 @@ int msm_gem_get_iova(struct drm_gem_object *obj,
 	struct msm_gem_vma *vma;
 	int ret = 0;
 
+	/*
+	 * Fast path for objects already mapped and tracked in this aspace,
+	 * as the plane and writeback paths ask for the same iova each frame.
+	 */
+	rcu_read_lock();
+	vma = lookup_vma_rcu(msm_obj, aspace);
+	if (vma && READ_ONCE(msm_obj->madv) == MSM_MADV_WILLNEED &&
+			READ_ONCE(msm_obj->in_active_list)) {
+		*iova = vma->iova;
+		rcu_read_unlock();
+		return 0;
+	}
+	rcu_read_unlock();
+
 	mutex_lock(&msm_obj->lock);
 
 	if (WARN_ON(msm_obj->madv != MSM_MADV_WILLNEED)) {
@@ -489,6 +547,9 @@ int msm_gem_get_iova(struct drm_gem_object *obj,
 				msm_obj->flags);
 		if (ret)
 			goto fail;
+
+		if (vma_slot(msm_obj, aspace))
+			rcu_assign_pointer(*vma_slot(msm_obj, aspace), vma);
 	}
 
 	*iova = vma->iova;
@@ -503,7 +564,7 @@ int msm_gem_get_iova(struct drm_gem_object *obj,
 	return 0;
 
 fail:
-	del_vma(vma);
+	del_vma(msm_obj, vma);
 unlock:
 	mutex_unlock(&msm_obj->lock);
 	return ret;
@@ -517,24 +578,37 @@ uint64_t msm_gem_iova(struct drm_gem_object *obj,
 {
 	struct msm_gem_object *msm_obj = to_msm_bo(obj);
 	struct msm_gem_vma *vma;
+	uint64_t iova = 0;
+
+	rcu_read_lock();
+	vma = lookup_vma_rcu(msm_obj, aspace);
+	if (vma)
+		iova = vma->iova;
+	rcu_read_unlock();
+
+	if (vma)
+		return iova;
 
 	mutex_lock(&msm_obj->lock);
 	vma = lookup_vma(obj, aspace);
+	if (vma)
+		iova = vma->iova;
 	mutex_unlock(&msm_obj->lock);
 	WARN_ON(!vma);
 
-	return vma ? vma->iova : 0;
+	return iova;
 }
 
 void msm_gem_put_iova(struct drm_gem_object *obj,
 		struct msm_gem_address_space *aspace)
 {
-	// XXX TODO ..
-	// NOTE: probably don't need a _locked() version.. we wouldn't
-	// normally unmap here, but instead just mark that it could be
-	// unmapped (if the iova refcnt drops to zero), but then later
-	// if another _get_iova_locked() fails we can start unmapping
-	// things that are no longer needed..
+	/*
+	 * Mappings are deliberately kept until the object is freed or
+	 * purged, or the aspace domain is detached (see put_iova()). A
+	 * buffer cycling through a swapchain is therefore mapped once and
+	 * later msm_gem_get_iova() calls hit the existing vma, so there is
+	 * no per-frame unmap, remap or TLB invalidate to defer here.
+	 */
 }
 
 void msm_gem_aspace_domain_attach_detach_update(
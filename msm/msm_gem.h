@@ -21,6 +21,7 @@
 
 #include <linux/kref.h>
 #include <linux/reservation.h>
+#include <linux/rcupdate.h>
 #include "msm_drv.h"
 
 /* Additional internal-use only BO flags: */
@@ -58,6 +59,9 @@ struct aspace_client {
 };
 
 
+/* number of address spaces with a direct vma slot in each gem object */
+#define MSM_GEM_VMA_SLOTS 8
+
 struct msm_gem_address_space {
 	const char *name;
 	/* NOTE: mm managed at the page level, size is in # of pages
@@ -75,6 +79,8 @@ struct msm_gem_address_space {
 	/* list of clients */
 	struct list_head clients;
 	struct mutex list_lock; /* Protects active_list & clients */
+	/* index into msm_gem_object::vma_slots, -1 if none is free */
+	int id;
 };
 
 struct msm_gem_vma {
@@ -82,6 +88,7 @@ struct msm_gem_vma {
 	uint64_t iova;
 	struct msm_gem_address_space *aspace;
 	struct list_head list;    /* node in msm_gem_object::vmas */
+	struct rcu_head rcu;
 };
 
 struct msm_gem_object {
@@ -123,6 +130,11 @@ struct msm_gem_object {
 
 	struct list_head vmas;    /* list of msm_gem_vma */
 
+	/* mapped vmas indexed by aspace id, readable under rcu without
+	 * taking msm_obj->lock; updated with msm_obj->lock held
+	 */
+	struct msm_gem_vma __rcu *vma_slots[MSM_GEM_VMA_SLOTS];
+
 	/* normally (resv == &_resv) except for imported bo's */
 	struct reservation_object *resv;
 	struct reservation_object _resv;
@@ -16,10 +16,23 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <linux/idr.h>
+
 #include "msm_drv.h"
 #include "msm_gem.h"
 #include "msm_mmu.h"
 
+static DEFINE_IDA(msm_gem_aspace_ida);
+
+static void msm_gem_address_space_init_id(
+		struct msm_gem_address_space *aspace)
+{
+	aspace->id = ida_simple_get(&msm_gem_aspace_ida, 0,
+			MSM_GEM_VMA_SLOTS, GFP_KERNEL);
+	if (aspace->id < 0)
+		aspace->id = -1;
+}
+
 /* SDE address space operations */
 static void smmu_aspace_unmap_vma(struct msm_gem_address_space *aspace,
 		struct msm_gem_vma *vma, struct sg_table *sgt,
@@ -187,6 +200,7 @@ msm_gem_smmu_address_space_create(struct drm_device *dev, struct msm_mmu *mmu,
 	INIT_LIST_HEAD(&aspace->clients);
 	kref_init(&aspace->kref);
 	mutex_init(&aspace->list_lock);
+	msm_gem_address_space_init_id(aspace);
 
 	return aspace;
 }
@@ -277,6 +291,7 @@ msm_gem_address_space_create(struct device *dev, struct iommu_domain *domain,
 			(domain->geometry.aperture_end >> PAGE_SHIFT) - 1);
 
 	kref_init(&aspace->kref);
+	msm_gem_address_space_init_id(aspace);
 
 	return aspace;
 }
@@ -292,6 +307,9 @@ msm_gem_address_space_destroy(struct kref *kref)
 	if (aspace && aspace->ops->destroy)
 		aspace->ops->destroy(aspace);
 
+	if (aspace->id >= 0)
+		ida_simple_remove(&msm_gem_aspace_ida, aspace->id);
+
 	kfree(aspace);
 }
 
@@ -5,6 +5,9 @@
 
 #include "msm_prop.h"
 
+/* max span of the property id table, relative to the property count */
+#define MSM_PROP_ID_MAP_SPAN(count)	((count) * 4 + 64)
+
 void msm_property_init(struct msm_property_info *info,
 		struct drm_mode_object *base,
 		struct drm_device *dev,
@@ -41,7 +44,9 @@ void msm_property_init(struct msm_property_info *info,
 		info->blob_count = blob_count;
 		info->install_request = 0;
 		info->install_count = 0;
-		info->recent_idx = 0;
+		info->id_map = NULL;
+		info->id_base = 0;
+		info->id_map_size = 0;
 		info->is_active = false;
 		info->state_size = state_size;
 		info->state_cache_size = 0;
@@ -63,6 +68,10 @@ void msm_property_destroy(struct msm_property_info *info)
 	while (info->state_cache_size > 0)
 		kfree(info->state_cache[--(info->state_cache_size)]);
 
+	kfree(info->id_map);
+	info->id_map = NULL;
+	info->id_map_size = 0;
+
 	mutex_destroy(&info->property_lock);
 }
 
@@ -135,6 +144,61 @@ bool msm_property_is_dirty(
 	return !list_empty(&property_state->values[property_idx].dirty_node);
 }
 
+/**
+ * _msm_property_map_id - add property to the object id lookup table
+ *                        Called at install time only, before the object is
+ *                        visible to user space, so the table never changes
+ *                        while msm_property_index may be reading it.
+ * @info: Pointer to property info container struct
+ * @property_idx: Property index
+ */
+static void _msm_property_map_id(struct msm_property_info *info,
+		uint32_t property_idx)
+{
+	uint32_t id, base, end, size;
+	uint16_t *map;
+
+	id = info->property_array[property_idx]->base.id;
+	if (!info->id_map) {
+		base = id;
+		end = id + 1;
+	} else {
+		base = min(info->id_base, id);
+		end = max(info->id_base + info->id_map_size, id + 1);
+	}
+	size = end - base;
+
+	if (size > MSM_PROP_ID_MAP_SPAN(info->property_count)) {
+		/* ids too sparse, msm_property_index will search linearly */
+		DRM_DEBUG_KMS("property id span %u too large\n", size);
+		kfree(info->id_map);
+		info->id_map = NULL;
+		info->id_map_size = 0;
+		return;
+	}
+
+	if (size != info->id_map_size) {
+		map = kcalloc(size, sizeof(*map), GFP_KERNEL);
+		if (!map) {
+			kfree(info->id_map);
+			info->id_map = NULL;
+			info->id_map_size = 0;
+			return;
+		}
+
+		if (info->id_map)
+			memcpy(map + (info->id_base - base), info->id_map,
+					info->id_map_size * sizeof(*map));
+		kfree(info->id_map);
+
+		info->id_map = map;
+		info->id_base = base;
+		info->id_map_size = size;
+	}
+
+	info->id_map[id - base] = property_idx + 1;
+}
+
 /**
  * _msm_property_install_integer - install standard drm range property
  * @info: Pointer to property info container struct
@@ -179,6 +243,7 @@ static void _msm_property_install_integer(struct msm_property_info *info,
 		/* always attach property, if created */
 		if (*prop) {
 			drm_object_attach_property(info->base, *prop, init);
+			_msm_property_map_id(info, property_idx);
 			++info->install_count;
 		}
 	}
@@ -249,6 +314,7 @@ void msm_property_install_enum(struct msm_property_info *info,
 			drm_object_attach_property(info->base, *prop,
 					info->property_data
 					[property_idx].default_value);
+			_msm_property_map_id(info, property_idx);
 			++info->install_count;
 		}
 	}
@@ -287,6 +353,7 @@ void msm_property_install_blob(struct msm_property_info *info,
 		/* always attach property, if created */
 		if (*prop) {
 			drm_object_attach_property(info->base, *prop, -1);
+			_msm_property_map_id(info, property_idx);
 			++info->install_count;
 		}
 	}
@@ -305,41 +372,32 @@ int msm_property_install_get_status(struct msm_property_info *info)
 int msm_property_index(struct msm_property_info *info,
 		struct drm_property *property)
 {
-	uint32_t count;
+	uint32_t offset;
 	int32_t idx;
-	int rc = -EINVAL;
 
 	if (!info || !property) {
 		DRM_ERROR("invalid argument(s)\n");
-	} else {
-		/*
-		 * Linear search, but start from last found index. This will
-		 * help if any single property is accessed multiple times in a
-		 * row. Ideally, we could keep a list of properties sorted in
-		 * the order of most recent access, but that may be overkill
-		 * for now.
-		 */
-		mutex_lock(&info->property_lock);
-		idx = info->recent_idx;
-		count = info->property_count;
-		while (count) {
-			--count;
-
-			/* stop searching on match */
-			if (info->property_array[idx] == property) {
-				info->recent_idx = idx;
-				rc = idx;
-				break;
-			}
+		return -EINVAL;
+	}
 
-			/* move to next valid index */
-			if (--idx < 0)
-				idx = info->property_count - 1;
-		}
-		mutex_unlock(&info->property_lock);
+	/*
+	 * Direct lookup through the id table built at install time. Both the
+	 * table and property_array are immutable once installed, so no lock
+	 * is needed here.
+	 */
+	offset = property->base.id - info->id_base;
+	if (info->id_map && offset < info->id_map_size) {
+		idx = (int32_t)info->id_map[offset] - 1;
+		if (idx >= 0 && info->property_array[idx] == property)
+			return idx;
 	}
 
-	return rc;
+	/* fall back to a linear search if the id isn't in the table */
+	for (idx = 0; idx < info->property_count; ++idx)
+		if (info->property_array[idx] == property)
+			return idx;
+
+	return -EINVAL;
 }
 
 int msm_property_set_dirty(struct msm_property_info *info,
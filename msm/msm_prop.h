@@ -46,7 +46,9 @@ struct msm_property_value {
  * @blob_count: Total number of blob properties, should be <= count
  * @install_request: Total number of property 'install' requests
  * @install_count: Total number of successful 'install' requests
- * @recent_idx: Index of property most recently accessed by set/get
+ * @id_map: Table mapping property object id - id_base to property index + 1
+ * @id_base: Lowest property object id covered by id_map
+ * @id_map_size: Number of entries in id_map
  * @is_active: Whether or not drm component properties are 'active'
  * @state_cache: Cache of local states, to prevent alloc/free thrashing
  * @state_size: Size of local state structures
@@ -64,7 +66,9 @@ struct msm_property_info {
 	uint32_t install_request;
 	uint32_t install_count;
 
-	int32_t recent_idx;
+	uint16_t *id_map;
+	uint32_t id_base;
+	uint32_t id_map_size;
 
 	bool is_active;
 
@@ -11,6 +11,7 @@
 #include "sde_crtc.h"
 #include "sde_hw_dspp.h"
 #include "sde_hw_lm.h"
+#include "sde_hw_reg_dma_v1_color_proc.h"
 #include "sde_ad4.h"
 #include "sde_hw_interrupts.h"
 #include "sde_core_irq.h"
@@ -852,13 +853,44 @@ static void sde_cp_crtc_setfeature(struct sde_cp_node *prop_node,
 	list_del_init(&prop_node->dirty_list);
 }
 
+/*
+ * Batch the reg dma programming of all dirty dspp features into one kick
+ * off per ctl instead of one kick off per feature.
+ */
+static u32 _sde_cp_crtc_batch_begin(struct sde_crtc *sde_crtc)
+{
+	struct sde_hw_ctl *ctl;
+	u32 i, batch_mask = 0;
+
+	for (i = 0; i < sde_crtc->num_mixers; i++) {
+		ctl = sde_crtc->mixers[i].hw_ctl;
+		if (!ctl || (i && ctl == sde_crtc->mixers[i - 1].hw_ctl))
+			continue;
+
+		if (!reg_dmav1_dspp_batch_begin(ctl))
+			batch_mask |= BIT(i);
+	}
+
+	return batch_mask;
+}
+
+static void _sde_cp_crtc_batch_end(struct sde_crtc *sde_crtc, u32 batch_mask)
+{
+	u32 i;
+
+	for (i = 0; i < sde_crtc->num_mixers; i++) {
+		if (batch_mask & BIT(i))
+			reg_dmav1_dspp_batch_end(sde_crtc->mixers[i].hw_ctl);
+	}
+}
+
 void sde_cp_crtc_apply_properties(struct drm_crtc *crtc)
 {
 	struct sde_crtc *sde_crtc = NULL;
 	bool set_dspp_flush = false, set_lm_flush = false;
 	struct sde_cp_node *prop_node = NULL, *n = NULL;
 	struct sde_hw_ctl *ctl;
-	u32 num_mixers = 0, i = 0;
+	u32 num_mixers = 0, i = 0, batch_mask = 0;
 
 	if (!crtc || !crtc->dev) {
 		DRM_ERROR("invalid crtc %pK dev %pK\n", crtc,
@@ -897,6 +929,9 @@ void sde_cp_crtc_apply_properties(struct drm_crtc *crtc)
 		sde_cp_ad_set_prop(sde_crtc, AD_IPC_RESET);
 	}
 
+	if (!list_empty(&sde_crtc->dirty_list))
+		batch_mask = _sde_cp_crtc_batch_begin(sde_crtc);
+
 	list_for_each_entry_safe(prop_node, n, &sde_crtc->dirty_list,
 				dirty_list) {
 		sde_cp_crtc_setfeature(prop_node, sde_crtc);
@@ -907,6 +942,8 @@ void sde_cp_crtc_apply_properties(struct drm_crtc *crtc)
 			set_lm_flush = true;
 	}
 
+	_sde_cp_crtc_batch_end(sde_crtc, batch_mask);
+
 	list_for_each_entry_safe(prop_node, n, &sde_crtc->ad_dirty,
 				dirty_list) {
 		set_dspp_flush = true;
@@ -6,9 +6,11 @@
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
 
 #include <linux/debugfs.h>
+#include <linux/interrupt.h>
 #include <linux/irqdomain.h>
 #include <linux/irq.h>
 #include <linux/kthread.h>
+#include <linux/rculist.h>
 
 #include "sde_core_irq.h"
 #include "sde_power_handle.h"
@@ -23,15 +25,21 @@ static void sde_core_irq_callback_handler(void *arg, int irq_idx)
 	struct sde_kms *sde_kms = arg;
 	struct sde_irq *irq_obj = &sde_kms->irq_obj;
 	struct sde_irq_callback *cb;
-	unsigned long irq_flags;
 	bool cb_tbl_error = false;
 	int enable_counts = 0;
 
 	pr_debug("irq_idx=%d\n", irq_idx);
 
-	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
+	/*
+	 * The callback list is walked without cb_lock. Writers wait for
+	 * cb_active to drop to zero before a removed entry can be reused.
+	 */
+	atomic_inc(&irq_obj->cb_active[irq_idx]);
+	smp_mb__after_atomic();
+
+	rcu_read_lock();
 	if (list_empty(&irq_obj->irq_cb_tbl[irq_idx])) {
-		/* print error outside lock */
+		/* print error outside the callback section */
 		cb_tbl_error = true;
 		enable_counts = atomic_read(
 				&sde_kms->irq_obj.enable_counts[irq_idx]);
@@ -42,10 +50,13 @@ static void sde_core_irq_callback_handler(void *arg, int irq_idx)
 	/*
 	 * Perform registered function callback
 	 */
-	list_for_each_entry(cb, &irq_obj->irq_cb_tbl[irq_idx], list)
+	list_for_each_entry_rcu(cb, &irq_obj->irq_cb_tbl[irq_idx], list)
 		if (cb->func)
 			cb->func(cb->arg, irq_idx);
-	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
+	rcu_read_unlock();
+
+	smp_mb__before_atomic();
+	atomic_dec(&irq_obj->cb_active[irq_idx]);
 
 	if (cb_tbl_error) {
 		/*
@@ -286,6 +297,31 @@ u32 sde_core_irq_read(struct sde_kms *sde_kms, int irq_idx, bool clear)
 			irq_idx, clear);
 }
 
+/**
+ * _sde_core_irq_remove_callback - remove a callback from its irq list
+ * @irq_obj:		Pointer to irq object
+ * @irq_idx:		interrupt index the callback is registered on
+ * @cb:			Pointer to callback, may be on no list
+ *
+ * Must be called with cb_lock held. Unregistration can happen in atomic
+ * context, so instead of synchronize_rcu() this spins until no handler
+ * is walking the irq list, after which @cb can be reused or freed.
+ */
+static void _sde_core_irq_remove_callback(struct sde_irq *irq_obj,
+		int irq_idx, struct sde_irq_callback *cb)
+{
+	if (list_empty(&cb->list))
+		return;
+
+	list_del_rcu(&cb->list);
+
+	smp_mb();
+	while (atomic_read(&irq_obj->cb_active[irq_idx]))
+		cpu_relax();
+
+	INIT_LIST_HEAD(&cb->list);
+}
+
 int sde_core_irq_register_callback(struct sde_kms *sde_kms, int irq_idx,
 		struct sde_irq_callback *register_irq_cb)
 {
@@ -313,8 +349,9 @@ int sde_core_irq_register_callback(struct sde_kms *sde_kms, int irq_idx,
 
 	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
 	SDE_EVT32(irq_idx, register_irq_cb);
-	list_del_init(&register_irq_cb->list);
-	list_add_tail(&register_irq_cb->list,
+	_sde_core_irq_remove_callback(&sde_kms->irq_obj, irq_idx,
+			register_irq_cb);
+	list_add_tail_rcu(&register_irq_cb->list,
 			&sde_kms->irq_obj.irq_cb_tbl[irq_idx]);
 	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
 
@@ -348,7 +385,8 @@ int sde_core_irq_unregister_callback(struct sde_kms *sde_kms, int irq_idx,
 
 	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
 	SDE_EVT32(irq_idx, register_irq_cb);
-	list_del_init(&register_irq_cb->list);
+	_sde_core_irq_remove_callback(&sde_kms->irq_obj, irq_idx,
+			register_irq_cb);
 	/* empty callback list but interrupt is still enabled */
 	if (list_empty(&sde_kms->irq_obj.irq_cb_tbl[irq_idx]) &&
 			atomic_read(&sde_kms->irq_obj.enable_counts[irq_idx]))
@@ -489,8 +527,11 @@ void sde_core_irq_preinstall(struct sde_kms *sde_kms)
 			sizeof(atomic_t), GFP_KERNEL);
 	sde_kms->irq_obj.irq_counts = kcalloc(sde_kms->irq_obj.total_irqs,
 			sizeof(atomic_t), GFP_KERNEL);
+	sde_kms->irq_obj.cb_active = kcalloc(sde_kms->irq_obj.total_irqs,
+			sizeof(atomic_t), GFP_KERNEL);
 	if (!sde_kms->irq_obj.irq_cb_tbl || !sde_kms->irq_obj.enable_counts
-			|| !sde_kms->irq_obj.irq_counts)
+			|| !sde_kms->irq_obj.irq_counts
+			|| !sde_kms->irq_obj.cb_active)
 		return;
 
 	for (i = 0; i < sde_kms->irq_obj.total_irqs; i++) {
@@ -500,6 +541,8 @@ void sde_core_irq_preinstall(struct sde_kms *sde_kms)
 			atomic_set(&sde_kms->irq_obj.enable_counts[i], 0);
 		if (sde_kms->irq_obj.irq_counts)
 			atomic_set(&sde_kms->irq_obj.irq_counts[i], 0);
+		if (sde_kms->irq_obj.cb_active)
+			atomic_set(&sde_kms->irq_obj.cb_active[i], 0);
 	}
 }
 
@@ -544,13 +587,26 @@ void sde_core_irq_uninstall(struct sde_kms *sde_kms)
 	sde_disable_all_irqs(sde_kms);
 	sde_power_resource_enable(&priv->phandle, sde_kms->core_client, false);
 
+	/*
+	 * The callback handler walks the irq tables without cb_lock, so let
+	 * any handler still running on another cpu finish before freeing.
+	 */
+	if (sde_kms->irq_num >= 0)
+		synchronize_irq(sde_kms->irq_num);
+	for (i = 0; i < sde_kms->irq_obj.total_irqs; i++)
+		while (atomic_read(&sde_kms->irq_obj.cb_active[i]))
+			cpu_relax();
+	synchronize_rcu();
+
 	spin_lock_irqsave(&sde_kms->irq_obj.cb_lock, irq_flags);
 	kfree(sde_kms->irq_obj.irq_cb_tbl);
 	kfree(sde_kms->irq_obj.enable_counts);
 	kfree(sde_kms->irq_obj.irq_counts);
+	kfree(sde_kms->irq_obj.cb_active);
 	sde_kms->irq_obj.irq_cb_tbl = NULL;
 	sde_kms->irq_obj.enable_counts = NULL;
 	sde_kms->irq_obj.irq_counts = NULL;
+	sde_kms->irq_obj.cb_active = NULL;
 	sde_kms->irq_obj.total_irqs = 0;
 	spin_unlock_irqrestore(&sde_kms->irq_obj.cb_lock, irq_flags);
 }
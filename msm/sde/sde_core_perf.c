@@ -29,11 +29,13 @@ static DEFINE_MUTEX(sde_core_perf_lock);
  * @SDE_PERF_MODE_NORMAL: performance controlled by user mode client
  * @SDE_PERF_MODE_MINIMUM: performance bounded by minimum setting
  * @SDE_PERF_MODE_FIXED: performance bounded by fixed setting
+ * @SDE_PERF_MODE_ESTIMATE: performance estimated from the plane states
  */
 enum sde_perf_mode {
 	SDE_PERF_MODE_NORMAL,
 	SDE_PERF_MODE_MINIMUM,
 	SDE_PERF_MODE_FIXED,
+	SDE_PERF_MODE_ESTIMATE,
 	SDE_PERF_MODE_MAX
 };
 
@@ -77,6 +79,234 @@ static bool _sde_core_perf_crtc_is_power_on(struct drm_crtc *crtc)
 	return sde_crtc_is_enabled(crtc);
 }
 
+/* fixed point unit used by the estimator factors */
+#define SDE_PERF_EST_UNIT		1000
+
+/**
+ * _sde_core_perf_parse_fixed - parse a decimal string like "1.23"
+ * @str: Pointer to string, updated to the first unparsed character
+ * return: parsed value in SDE_PERF_EST_UNIT units
+ */
+static u32 _sde_core_perf_parse_fixed(const char **str)
+{
+	const char *p = *str;
+	u32 val = 0, frac = SDE_PERF_EST_UNIT;
+
+	for (; *p >= '0' && *p <= '9'; p++)
+		val = val * 10 + (*p - '0');
+	val *= SDE_PERF_EST_UNIT;
+
+	if (*p == '.') {
+		for (p++; *p >= '0' && *p <= '9'; p++) {
+			frac /= 10;
+			val += (*p - '0') * frac;
+		}
+	}
+
+	*str = p;
+	return val;
+}
+
+/**
+ * _sde_core_perf_parse_comp_ratio - parse a catalog compression ratio string
+ * @str: string of 0 or more of <fourcc>/<ven>/<mod>/<comp ratio>
+ * @table: Pointer to output table
+ * @max: number of entries in @table
+ * return: number of valid entries parsed into @table
+ */
+static u32 _sde_core_perf_parse_comp_ratio(const char *str,
+		struct sde_core_perf_comp_ratio *table, u32 max)
+{
+	u32 count = 0, vendor, mod;
+	char *end;
+
+	while (str && *str && count < max) {
+		str = skip_spaces(str);
+		if (strnlen(str, 5) < 5 || str[4] != '/')
+			break;
+
+		table[count].format = fourcc_code(str[0], str[1],
+				str[2], str[3]);
+		vendor = simple_strtoul(str + 5, &end, 0);
+		if (*end != '/')
+			break;
+		mod = simple_strtoul(end + 1, &end, 0);
+		if (*end != '/')
+			break;
+		str = end + 1;
+
+		table[count].modifier = fourcc_mod_code(vendor, mod);
+		table[count].ratio = _sde_core_perf_parse_fixed(&str);
+		if (table[count].ratio)
+			count++;
+	}
+
+	return count;
+}
+
+static void _sde_core_perf_est_init(struct sde_core_perf *perf)
+{
+	struct sde_core_perf_est_cfg *est = &perf->est_cfg;
+	struct sde_perf_cfg *cfg = &perf->catalog->perf;
+	const char *str;
+
+	str = cfg->core_ib_ff;
+	est->ib_ff = str ? _sde_core_perf_parse_fixed(&str) : 0;
+	if (!est->ib_ff)
+		est->ib_ff = SDE_PERF_EST_UNIT;
+
+	str = cfg->core_clk_ff;
+	est->clk_ff = str ? _sde_core_perf_parse_fixed(&str) : 0;
+	if (!est->clk_ff)
+		est->clk_ff = SDE_PERF_EST_UNIT;
+
+	est->comp_rt_count = _sde_core_perf_parse_comp_ratio(
+			cfg->comp_ratio_rt, est->comp_rt,
+			ARRAY_SIZE(est->comp_rt));
+	est->comp_nrt_count = _sde_core_perf_parse_comp_ratio(
+			cfg->comp_ratio_nrt, est->comp_nrt,
+			ARRAY_SIZE(est->comp_nrt));
+}
+
+static u32 _sde_core_perf_est_comp_ratio(struct sde_core_perf_est_cfg *est,
+		struct drm_framebuffer *fb, bool nrt)
+{
+	struct sde_core_perf_comp_ratio *table;
+	u32 i, count;
+
+	table = nrt ? est->comp_nrt : est->comp_rt;
+	count = nrt ? est->comp_nrt_count : est->comp_rt_count;
+
+	for (i = 0; i < count; i++)
+		if (table[i].format == fb->format->format &&
+				table[i].modifier == fb->modifier)
+			return table[i].ratio;
+
+	return SDE_PERF_EST_UNIT;
+}
+
+static u32 _sde_core_perf_est_prefill_lines(struct sde_perf_cfg *cfg,
+		const struct sde_format *fmt, bool downscale)
+{
+	u32 lines = cfg->xtra_prefill_lines;
+
+	if (SDE_FORMAT_IS_UBWC(fmt) || SDE_FORMAT_IS_TILE(fmt))
+		lines += cfg->macrotile_prefill_lines;
+	else if (SDE_FORMAT_IS_YUV(fmt))
+		lines += cfg->yuv_nv12_prefill_lines;
+	else
+		lines += cfg->linear_prefill_lines;
+
+	if (downscale)
+		lines += cfg->downscaling_prefill_lines;
+
+	return max(lines, cfg->min_prefill_lines);
+}
+
+/**
+ * _sde_core_perf_calc_crtc_estimate - estimate crtc performance from planes
+ * @kms: Pointer to sde kms
+ * @crtc: Pointer to drm crtc
+ * @state: Pointer to new crtc state
+ * @perf: Pointer to performance parameters to populate
+ *
+ * The average bandwidth is the sum of the per frame fetch of every plane,
+ * scaled down by the catalog compression ratio. The instantaneous
+ * bandwidth is the worst pipe fetch within one output line time, including
+ * the vertical downscale ratio and the prefill lines that must be fetched
+ * during vertical blanking. The core clock has to process one mixer line
+ * per output line, multiplied by the worst vertical downscale ratio.
+ */
+static void _sde_core_perf_calc_crtc_estimate(struct sde_kms *kms,
+		struct drm_crtc *crtc,
+		struct drm_crtc_state *state,
+		struct sde_core_perf_params *perf)
+{
+	struct sde_core_perf_est_cfg *est = &kms->perf.est_cfg;
+	struct sde_perf_cfg *cfg = &kms->catalog->perf;
+	struct drm_display_mode *mode = &state->adjusted_mode;
+	const struct drm_plane_state *pstate;
+	struct drm_plane *plane;
+	u64 ab = 0, ib = 0, clk, line_rate, max_bw;
+	u32 fps, vtotal, vblank, mixer_width, num_lm;
+	u32 max_vscale = SDE_PERF_EST_UNIT;
+	bool nrt;
+	int i;
+
+	fps = drm_mode_vrefresh(mode);
+	vtotal = mode->vtotal;
+	if (!fps || !vtotal || !mode->hdisplay || !mode->vdisplay)
+		return;
+
+	vblank = max_t(u32, vtotal - mode->vdisplay, 1);
+	line_rate = (u64)vtotal * fps;
+	nrt = sde_crtc_get_client_type(crtc) == NRT_CLIENT;
+
+	drm_atomic_crtc_state_for_each_plane_state(plane, pstate, state) {
+		const struct sde_format *fmt;
+		u32 src_w, src_h, dst_h, vscale, comp, lines;
+		u64 line_bytes, pipe_ib, prefill;
+
+		if (IS_ERR_OR_NULL(pstate) || !pstate->fb ||
+				!pstate->crtc_h || !pstate->crtc_w)
+			continue;
+
+		fmt = to_sde_format(msm_framebuffer_format(pstate->fb));
+		src_w = pstate->src_w >> 16;
+		src_h = pstate->src_h >> 16;
+		dst_h = pstate->crtc_h;
+		if (pstate->rotation & DRM_MODE_ROTATE_90)
+			swap(src_w, src_h);
+
+		line_bytes = (u64)src_w * fmt->bpp;
+		if (fmt->chroma_sample == SDE_CHROMA_420)
+			line_bytes = DIV_ROUND_UP_ULL(line_bytes * 3, 4);
+
+		comp = _sde_core_perf_est_comp_ratio(est, pstate->fb, nrt);
+		ab += div_u64(line_bytes * src_h * fps * SDE_PERF_EST_UNIT,
+				comp);
+
+		vscale = DIV_ROUND_UP(src_h * SDE_PERF_EST_UNIT, dst_h);
+		vscale = max_t(u32, vscale, SDE_PERF_EST_UNIT);
+		max_vscale = max(max_vscale, vscale);
+
+		pipe_ib = div_u64(line_bytes * line_rate * vscale, comp);
+
+		lines = _sde_core_perf_est_prefill_lines(cfg, fmt,
+				vscale > SDE_PERF_EST_UNIT);
+		prefill = div_u64(line_bytes * lines * line_rate *
+				SDE_PERF_EST_UNIT, (u64)vblank * comp);
+
+		ib = max3(ib, pipe_ib, prefill);
+	}
+
+	ib = div_u64(ib * est->ib_ff, SDE_PERF_EST_UNIT);
+
+	max_bw = cfg->max_bw_high * 1000ULL;
+	if (max_bw) {
+		ab = min(ab, max_bw);
+		ib = min(ib, max_bw);
+	}
+
+	num_lm = 1;
+	if (kms->catalog->max_mixer_width)
+		num_lm = DIV_ROUND_UP(mode->hdisplay,
+				kms->catalog->max_mixer_width);
+	mixer_width = DIV_ROUND_UP(mode->hdisplay, num_lm);
+
+	clk = div_u64((u64)mixer_width * line_rate * max_vscale,
+			SDE_PERF_EST_UNIT);
+	clk = div_u64(clk * est->clk_ff, SDE_PERF_EST_UNIT);
+	clk = max(clk, kms->perf.perf_tune.min_core_clk);
+	clk = min(clk, kms->perf.max_core_clk_rate);
+
+	for (i = 0; i < SDE_POWER_HANDLE_DBUS_ID_MAX; i++) {
+		perf->bw_ctl[i] = ab;
+		perf->max_per_pipe_ib[i] = ib;
+	}
+	perf->core_clk_rate = clk;
+}
+
 static void _sde_core_perf_calc_crtc(struct sde_kms *kms,
 		struct drm_crtc *crtc,
 		struct drm_crtc_state *state,
@@ -140,6 +370,8 @@ static void _sde_core_perf_calc_crtc(struct sde_kms *kms,
 			perf->max_per_pipe_ib[i] = kms->perf.fix_core_ib_vote;
 		}
 		perf->core_clk_rate = kms->perf.fix_core_clk_rate;
+	} else if (kms->perf.perf_tune.mode == SDE_PERF_MODE_ESTIMATE) {
+		_sde_core_perf_calc_crtc_estimate(kms, crtc, state, perf);
 	}
 
 	SDE_EVT32(crtc->base.id, perf->core_clk_rate);
@@ -668,6 +900,11 @@ static ssize_t _sde_core_perf_mode_write(struct file *file,
 		perf->perf_tune.min_core_clk = 0;
 		perf->perf_tune.min_bus_vote = 0;
 		DRM_INFO("normal performance mode\n");
+	} else if (perf_mode == SDE_PERF_MODE_ESTIMATE) {
+		/* votes are derived from the plane states */
+		perf->perf_tune.min_core_clk = 0;
+		perf->perf_tune.min_bus_vote = 0;
+		DRM_INFO("estimated performance mode\n");
 	}
 	perf->perf_tune.mode = perf_mode;
 
@@ -831,6 +1068,8 @@ int sde_core_perf_init(struct sde_core_perf *perf,
 		perf->max_core_clk_rate = SDE_PERF_DEFAULT_MAX_CORE_CLK_RATE;
 	}
 
+	_sde_core_perf_est_init(perf);
+
 	return 0;
 
 err:
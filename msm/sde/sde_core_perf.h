@@ -16,6 +16,38 @@
 
 #define	SDE_PERF_DEFAULT_MAX_CORE_CLK_RATE	320000000
 
+#define SDE_PERF_EST_COMP_RATIO_MAX	16
+
+/**
+ * struct sde_core_perf_comp_ratio - compression ratio of a format/modifier
+ * @format: drm fourcc format
+ * @modifier: drm format modifier
+ * @ratio: compression ratio in 1/1000 units
+ */
+struct sde_core_perf_comp_ratio {
+	u32 format;
+	u64 modifier;
+	u32 ratio;
+};
+
+/**
+ * struct sde_core_perf_est_cfg - parsed catalog factors used by the estimator
+ * @ib_ff: core instantaneous bandwidth fudge factor in 1/1000 units
+ * @clk_ff: core clock fudge factor in 1/1000 units
+ * @comp_rt: compression ratios for real time clients
+ * @comp_rt_count: number of valid entries in @comp_rt
+ * @comp_nrt: compression ratios for non real time clients
+ * @comp_nrt_count: number of valid entries in @comp_nrt
+ */
+struct sde_core_perf_est_cfg {
+	u32 ib_ff;
+	u32 clk_ff;
+	struct sde_core_perf_comp_ratio comp_rt[SDE_PERF_EST_COMP_RATIO_MAX];
+	u32 comp_rt_count;
+	struct sde_core_perf_comp_ratio comp_nrt[SDE_PERF_EST_COMP_RATIO_MAX];
+	u32 comp_nrt_count;
+};
+
 /**
  * struct sde_core_perf_params - definition of performance parameters
  * @max_per_pipe_ib: maximum instantaneous bandwidth request
@@ -59,6 +91,7 @@ struct sde_core_perf_tune {
  * @bw_vote_mode: apps rsc vs display rsc bandwidth vote mode
  * @sde_rsc_available: is display rsc available
  * @bw_vote_mode_updated: bandwidth vote mode update
+ * @est_cfg: catalog factors for the plane based estimator used in mode 3
  */
 struct sde_core_perf {
 	struct drm_device *dev;
@@ -78,6 +111,7 @@ struct sde_core_perf {
 	u32 bw_vote_mode;
 	bool sde_rsc_available;
 	bool bw_vote_mode_updated;
+	struct sde_core_perf_est_cfg est_cfg;
 };
 
 /**
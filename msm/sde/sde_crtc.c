@@ -203,6 +203,80 @@ static struct drm_crtc *_sde_crtc_rp_to_crtc(struct sde_crtc_respool *rp)
 	return container_of(rp, struct sde_crtc_state, rp)->base.crtc;
 }
 
+/**
+ * _sde_crtc_res_key - get the resource pool index key of a resource
+ * @type: Resource type
+ * @tag: Search tag for given resource
+ * return: key for the res_hash index
+ */
+static inline u64 _sde_crtc_res_key(u32 type, u64 tag)
+{
+	return tag ^ ((u64)type << 32);
+}
+
+/**
+ * _sde_crtc_res_set_free - mark resource as free or in use, keeping the
+ *	free index of its resource pool in sync
+ * @rp: Pointer to resource pool
+ * @res: Pointer to resource
+ * @free: True to mark the resource free; otherwise, mark it in use
+ * return: None
+ */
+static void _sde_crtc_res_set_free(struct sde_crtc_respool *rp,
+		struct sde_crtc_res *res, bool free)
+{
+	if (free == !!(res->flags & SDE_CRTC_RES_FLAG_FREE))
+		return;
+
+	if (free) {
+		res->flags |= SDE_CRTC_RES_FLAG_FREE;
+		hash_add(rp->free_hash, &res->fnode, res->type);
+	} else {
+		res->flags &= ~SDE_CRTC_RES_FLAG_FREE;
+		hash_del(&res->fnode);
+	}
+}
+
+/**
+ * _sde_crtc_rp_insert - add resource to the list and indices of a pool
+ * @rp: Pointer to resource pool
+ * @res: Pointer to resource, flags must not be set yet
+ * @free: True to add the resource as free
+ * return: None
+ */
+static void _sde_crtc_rp_insert(struct sde_crtc_respool *rp,
+		struct sde_crtc_res *res, bool free)
+{
+	INIT_LIST_HEAD(&res->list);
+	INIT_HLIST_NODE(&res->fnode);
+	list_add_tail(&res->list, &rp->res_list);
+	hash_add(rp->res_hash, &res->hnode,
+			_sde_crtc_res_key(res->type, res->tag));
+	hash_add(rp->type_hash, &res->tnode, res->type);
+	_sde_crtc_res_set_free(rp, res, free);
+}
+
+/**
+ * _sde_crtc_rp_find - lookup resource in a pool by type and tag
+ * @rp: Pointer to resource pool
+ * @type: Resource type
+ * @tag: Search tag for given resource
+ * return: Pointer to resource if found; null otherwise
+ */
+static struct sde_crtc_res *_sde_crtc_rp_find(struct sde_crtc_respool *rp,
+		u32 type, u64 tag)
+{
+	struct sde_crtc_res *res;
+
+	hash_for_each_possible(rp->res_hash, res, hnode,
+			_sde_crtc_res_key(type, tag)) {
+		if (res->type == type && res->tag == tag)
+			return res;
+	}
+
+	return NULL;
+}
+
 /**
  * _sde_crtc_rp_reclaim - reclaim unused, or all if forced, resources in pool
  * @rp: Pointer to resource pool
@@ -231,6 +305,9 @@ static void _sde_crtc_rp_reclaim(struct sde_crtc_respool *rp, bool force)
 				res->type, res->tag, res->val,
 				atomic_read(&res->refcount));
 		list_del(&res->list);
+		hash_del(&res->hnode);
+		hash_del(&res->tnode);
+		_sde_crtc_res_set_free(rp, res, false);
 		if (res->ops.put)
 			res->ops.put(res->val);
 		kfree(res);
@@ -314,6 +391,9 @@ static void _sde_crtc_rp_duplicate(struct sde_crtc_respool *rp,
 	mutex_lock(rp->rp_lock);
 	dup_rp->sequence_id = rp->sequence_id + 1;
 	INIT_LIST_HEAD(&dup_rp->res_list);
+	hash_init(dup_rp->res_hash);
+	hash_init(dup_rp->type_hash);
+	hash_init(dup_rp->free_hash);
 	dup_rp->ops = rp->ops;
 	list_for_each_entry(res, &rp->res_list, list) {
 		dup_res = kzalloc(sizeof(struct sde_crtc_res), GFP_KERNEL);
@@ -321,18 +401,16 @@ static void _sde_crtc_rp_duplicate(struct sde_crtc_respool *rp,
 			mutex_unlock(rp->rp_lock);
 			return;
 		}
-		INIT_LIST_HEAD(&dup_res->list);
 		atomic_set(&dup_res->refcount, 0);
 		dup_res->type = res->type;
 		dup_res->tag = res->tag;
 		dup_res->val = res->val;
 		dup_res->ops = res->ops;
-		dup_res->flags = SDE_CRTC_RES_FLAG_FREE;
+		_sde_crtc_rp_insert(dup_rp, dup_res, true);
 		SDE_DEBUG("crtc%d.%u dup res:0x%x/0x%llx/%pK/%d\n",
 				crtc->base.id, dup_rp->sequence_id,
 				dup_res->type, dup_res->tag, dup_res->val,
 				atomic_read(&dup_res->refcount));
-		list_add_tail(&dup_res->list, &dup_rp->res_list);
 		if (dup_res->ops.get)
 			dup_res->ops.get(dup_res->val, 0, -1);
 	}
@@ -365,6 +443,9 @@ static void _sde_crtc_rp_reset(struct sde_crtc_respool *rp,
 	INIT_LIST_HEAD(&rp->rp_list);
 	rp->sequence_id = 0;
 	INIT_LIST_HEAD(&rp->res_list);
+	hash_init(rp->res_hash);
+	hash_init(rp->type_hash);
+	hash_init(rp->free_hash);
 	rp->ops.get = _sde_crtc_hw_blk_get;
 	rp->ops.put = _sde_crtc_hw_blk_put;
 	list_add_tail(&rp->rp_list, rp->rp_head);
@@ -397,9 +478,8 @@ static int _sde_crtc_rp_add_no_lock(struct sde_crtc_respool *rp, u32 type,
 		return -EINVAL;
 	}
 
-	list_for_each_entry(res, &rp->res_list, list) {
-		if (res->type != type || res->tag != tag)
-			continue;
+	res = _sde_crtc_rp_find(rp, type, tag);
+	if (res) {
 		SDE_ERROR("crtc%d.%u already exist res:0x%x/0x%llx/%pK/%d\n",
 				crtc->base.id, rp->sequence_id,
 				res->type, res->tag, res->val,
@@ -409,13 +489,12 @@ static int _sde_crtc_rp_add_no_lock(struct sde_crtc_respool *rp, u32 type,
 	res = kzalloc(sizeof(struct sde_crtc_res), GFP_KERNEL);
 	if (!res)
 		return -ENOMEM;
-	INIT_LIST_HEAD(&res->list);
 	atomic_set(&res->refcount, 1);
 	res->type = type;
 	res->tag = tag;
 	res->val = val;
 	res->ops = *ops;
-	list_add_tail(&res->list, &rp->res_list);
+	_sde_crtc_rp_insert(rp, res, false);
 	SDE_DEBUG("crtc%d.%u added res:0x%x/0x%llx\n",
 			crtc->base.id, rp->sequence_id, type, tag);
 	return 0;
@@ -474,28 +553,30 @@ static void *_sde_crtc_rp_get(struct sde_crtc_respool *rp, u32 type, u64 tag)
 	}
 
 	mutex_lock(rp->rp_lock);
-	list_for_each_entry(res, &rp->res_list, list) {
-		if (res->type != type || res->tag != tag)
-			continue;
+	res = _sde_crtc_rp_find(rp, type, tag);
+	if (res) {
 		SDE_DEBUG("crtc%d.%u found res:0x%x/0x%llx/%pK/%d\n",
 				crtc->base.id, rp->sequence_id,
 				res->type, res->tag, res->val,
 				atomic_read(&res->refcount));
 		atomic_inc(&res->refcount);
-		res->flags &= ~SDE_CRTC_RES_FLAG_FREE;
+		_sde_crtc_res_set_free(rp, res, false);
 		mutex_unlock(rp->rp_lock);
 		return res->val;
 	}
-	list_for_each_entry(res, &rp->res_list, list) {
-		if (res->type != type || !(res->flags & SDE_CRTC_RES_FLAG_FREE))
+	hash_for_each_possible(rp->free_hash, res, fnode, type) {
+		if (res->type != type)
 			continue;
 		SDE_DEBUG("crtc%d.%u retag res:0x%x/0x%llx/%pK/%d\n",
 				crtc->base.id, rp->sequence_id,
 				res->type, res->tag, res->val,
 				atomic_read(&res->refcount));
 		atomic_inc(&res->refcount);
+		hash_del(&res->hnode);
 		res->tag = tag;
-		res->flags &= ~SDE_CRTC_RES_FLAG_FREE;
+		hash_add(rp->res_hash, &res->hnode,
+				_sde_crtc_res_key(type, tag));
+		_sde_crtc_res_set_free(rp, res, false);
 		mutex_unlock(rp->rp_lock);
 		return res->val;
 	}
@@ -520,7 +601,8 @@ static void *_sde_crtc_rp_get(struct sde_crtc_respool *rp, u32 type, u64 tag)
 			if (old_rp == rp)
 				continue;
 
-			list_for_each_entry(res, &old_rp->res_list, list) {
+			hash_for_each_possible(old_rp->type_hash, res, tnode,
+					type) {
 				if (res->type != type)
 					continue;
 				SDE_DEBUG(
@@ -573,7 +655,7 @@ add_res:
  */
 static void _sde_crtc_rp_put(struct sde_crtc_respool *rp, u32 type, u64 tag)
 {
-	struct sde_crtc_res *res, *next;
+	struct sde_crtc_res *res;
 	struct drm_crtc *crtc;
 
 	if (!rp) {
@@ -588,9 +670,8 @@ static void _sde_crtc_rp_put(struct sde_crtc_respool *rp, u32 type, u64 tag)
 	}
 
 	mutex_lock(rp->rp_lock);
-	list_for_each_entry_safe(res, next, &rp->res_list, list) {
-		if (res->type != type || res->tag != tag)
-			continue;
+	res = _sde_crtc_rp_find(rp, type, tag);
+	if (res) {
 		SDE_DEBUG("crtc%d.%u found res:0x%x/0x%llx/%pK/%d\n",
 				crtc->base.id, rp->sequence_id,
 				res->type, res->tag, res->val,
@@ -602,7 +683,7 @@ static void _sde_crtc_rp_put(struct sde_crtc_respool *rp, u32 type, u64 tag)
 					res->type, res->tag, res->val,
 					atomic_read(&res->refcount));
 		else if (atomic_dec_return(&res->refcount) == 0)
-			res->flags |= SDE_CRTC_RES_FLAG_FREE;
+			_sde_crtc_res_set_free(rp, res, true);
 
 		mutex_unlock(rp->rp_lock);
 		return;
@@ -2468,6 +2549,61 @@ static void _sde_crtc_swap_mixers_for_right_partial_update(
 			sde_crtc->mixers[1].hw_lm->idx - LM_0);
 }
 
+/**
+ * _sde_crtc_get_reg_rec_ctl - get the ctl recording the frame programming
+ * @sde_crtc: Pointer to sde crtc structure
+ * Returns: ctl if all mixers of the crtc are on one ctl, otherwise NULL
+ */
+static struct sde_hw_ctl *_sde_crtc_get_reg_rec_ctl(struct sde_crtc *sde_crtc)
+{
+	struct sde_hw_ctl *ctl = sde_crtc->mixers[0].hw_ctl;
+	int i;
+
+	if (!sde_crtc->num_mixers)
+		return NULL;
+
+	for (i = 1; i < sde_crtc->num_mixers; i++)
+		if (sde_crtc->mixers[i].hw_ctl != ctl)
+			return NULL;
+
+	return ctl;
+}
+
+/**
+ * _sde_crtc_reg_rec_attach - route the mixer and blend stage writes of the
+ *	crtc into the register record of its ctl
+ * @sde_crtc: Pointer to sde crtc structure
+ * @attach: true to route the writes into the record, false to restore
+ */
+static void _sde_crtc_reg_rec_attach(struct sde_crtc *sde_crtc, bool attach)
+{
+	struct sde_hw_ctl *ctl = _sde_crtc_get_reg_rec_ctl(sde_crtc);
+	struct sde_hw_reg_rec *rec;
+	int i;
+
+	if (!ctl || !ctl->rec)
+		return;
+
+	rec = attach ? ctl->rec : NULL;
+	ctl->hw.rec = rec;
+	for (i = 0; i < sde_crtc->num_mixers; i++)
+		if (sde_crtc->mixers[i].hw_lm)
+			sde_crtc->mixers[i].hw_lm->hw.rec = rec;
+}
+
+/**
+ * _sde_crtc_reg_rec_end - stop recording the frame programming of the crtc
+ * @sde_crtc: Pointer to sde crtc structure
+ * @kickoff: true to send the recorded writes by reg dma, false for ahb
+ */
+static void _sde_crtc_reg_rec_end(struct sde_crtc *sde_crtc, bool kickoff)
+{
+	struct sde_hw_ctl *ctl = _sde_crtc_get_reg_rec_ctl(sde_crtc);
+
+	if (ctl && ctl->ops.reg_rec_end)
+		ctl->ops.reg_rec_end(ctl, kickoff);
+}
+
 /**
  * _sde_crtc_blend_setup - configure crtc mixers
  * @crtc: Pointer to drm crtc structure
@@ -4155,8 +4291,10 @@ end:
 static void _sde_crtc_wait_for_fences(struct drm_crtc *crtc)
 {
 	struct drm_plane *plane = NULL;
-	uint32_t wait_ms = 1;
-	ktime_t kt_end, kt_wait;
+	void *fences[SDE_PSTATES_MAX];
+	uint32_t wait_ms = 1, count = 0, pending = 0;
+	ktime_t kt_start, kt_end, kt_wait;
+	signed long ret;
 	int rc = 0;
 
 	SDE_DEBUG("\n");
@@ -4167,20 +4305,47 @@ static void _sde_crtc_wait_for_fences(struct drm_crtc *crtc)
 	}
 
 	/* use monotonic timer to limit total fence wait time */
-	kt_end = ktime_add_ns(ktime_get(),
+	kt_start = ktime_get();
+	kt_end = ktime_add_ns(kt_start,
 		to_sde_crtc_state(crtc->state)->input_fence_timeout_ns);
 
+	drm_atomic_crtc_for_each_plane(plane, crtc) {
+		if (plane->state && count < SDE_PSTATES_MAX &&
+				to_sde_plane_state(plane->state)->input_fence)
+			fences[count++] =
+				to_sde_plane_state(plane->state)->input_fence;
+	}
+
+	SDE_ATRACE_BEGIN("plane_wait_input_fence");
+
 	/*
-	 * Wait for fences sequentially, as all of them need to be signalled
-	 * before we can proceed.
-	 *
-	 * Limit total wait time to INPUT_FENCE_TIMEOUT, but still call
-	 * sde_plane_wait_input_fence with wait_ms == 0 after the timeout so
-	 * that each plane can check its fence status and react appropriately
-	 * if its fence has timed out. Call input fence wait multiple times if
-	 * fence wait is interrupted due to interrupt call.
+	 * All fences need to be signalled before we can proceed, so wait for
+	 * the ones still pending together, limited to INPUT_FENCE_TIMEOUT.
+	 * Call the wait again if it is interrupted due to interrupt call.
+	 */
+	do {
+		kt_wait = ktime_sub(kt_end, ktime_get());
+		if (ktime_compare(kt_wait, ktime_set(0, 0)) >= 0)
+			wait_ms = ktime_to_ms(kt_wait);
+		else
+			wait_ms = 0;
+
+		ret = sde_sync_wait_multiple(fences, count, wait_ms, &pending);
+	} while (wait_ms && ret == -ERESTARTSYS);
+
+	if (pending)
+		SDE_EVT32(DRMID(crtc), count, pending, ret,
+			ktime_us_delta(ktime_get(), kt_start));
+
+	/*
+	 * Then let each plane check its own fence. After a successful
+	 * combined wait this only sees signaled fences; otherwise it
+	 * attributes the late fence to its plane, or falls back to waiting
+	 * sequentially in the remaining time if the combined wait could not
+	 * be set up. sde_plane_wait_input_fence is still called with
+	 * wait_ms == 0 after the timeout so that each plane can react
+	 * appropriately if its fence has timed out.
 	 */
-	SDE_ATRACE_BEGIN("plane_wait_input_fence");
 	drm_atomic_crtc_for_each_plane(plane, crtc) {
 		do {
 			kt_wait = ktime_sub(kt_end, ktime_get());
@@ -4360,6 +4525,7 @@ static void sde_crtc_atomic_begin(struct drm_crtc *crtc,
 	struct drm_device *dev;
 	struct sde_kms *sde_kms;
 	struct sde_splash_display *splash_display;
+	struct sde_hw_ctl *ctl;
 	bool cont_splash_enabled = false;
 	size_t i;
 
@@ -4411,12 +4577,22 @@ static void sde_crtc_atomic_begin(struct drm_crtc *crtc,
 	if (unlikely(!sde_crtc->num_mixers))
 		goto end;
 
+	/*
+	 * Hold back the sspp, mixer and blend stage programming of this
+	 * frame, it is sent by reg dma from sde_crtc_commit_kickoff.
+	 */
+	ctl = _sde_crtc_get_reg_rec_ctl(sde_crtc);
+	if (ctl && ctl->ops.reg_rec_begin)
+		ctl->ops.reg_rec_begin(ctl);
+
+	_sde_crtc_reg_rec_attach(sde_crtc, true);
 	if (_sde_crtc_get_ctlstart_timeout(crtc)) {
 		_sde_crtc_blend_setup(crtc, old_state, false);
 		SDE_ERROR("border fill only commit after ctlstart timeout\n");
 	} else {
 		_sde_crtc_blend_setup(crtc, old_state, true);
 	}
+	_sde_crtc_reg_rec_attach(sde_crtc, false);
 
 	_sde_crtc_dest_scaler_setup(crtc);
 
@@ -5011,9 +5187,11 @@ void sde_crtc_commit_kickoff(struct drm_crtc *crtc,
 
 	/*
 	 * Optionally attempt h/w recovery if any errors were detected while
-	 * preparing for the kickoff
+	 * preparing for the kickoff. The recorded frame programming has to
+	 * land before the recovery reprograms the mixers.
 	 */
 	if (reset_req) {
+		_sde_crtc_reg_rec_end(sde_crtc, false);
 		if (_sde_crtc_reset_hw(crtc, old_state, recovery_events))
 			is_error = true;
 	}
@@ -5049,6 +5227,9 @@ void sde_crtc_commit_kickoff(struct drm_crtc *crtc,
 
 	sde_vbif_clear_errors(sde_kms);
 
+	/* queue the recorded frame programming ahead of the ctl flush */
+	_sde_crtc_reg_rec_end(sde_crtc, !is_error);
+
 	if (is_error) {
 		_sde_crtc_remove_pipe_flush(crtc);
 		_sde_crtc_blend_setup(crtc, old_state, false);
@@ -5479,6 +5660,9 @@ static void sde_crtc_disable(struct drm_crtc *crtc)
 	mutex_lock(&sde_crtc->crtc_lock);
 	SDE_EVT32_VERBOSE(DRMID(crtc));
 
+	/* frame programming held back must not outlive the mixer setup */
+	_sde_crtc_reg_rec_end(sde_crtc, false);
+
 	/* update color processing on suspend */
 	event.type = DRM_EVENT_CRTC_POWER;
 	event.length = sizeof(u32);
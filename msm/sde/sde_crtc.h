@@ -20,6 +20,7 @@
 #define _SDE_CRTC_H_
 
 #include <linux/kthread.h>
+#include <linux/hashtable.h>
 #include <drm/drm_crtc.h>
 #include "msm_prop.h"
 #include "sde_fence.h"
@@ -356,9 +357,16 @@ struct sde_crtc_res_ops {
 
 #define SDE_CRTC_RES_FLAG_FREE		BIT(0)
 
+/* number of hash bits for the resource pool indices */
+#define SDE_CRTC_RES_HASH_BITS		4
+
 /**
  * struct sde_crtc_res - definition of crtc resources
  * @list: list of crtc resource
+ * @hnode: node in the resource pool index keyed by type and tag
+ * @tnode: node in the resource pool index keyed by type
+ * @fnode: node in the resource pool free index keyed by type, only hashed
+ *	while SDE_CRTC_RES_FLAG_FREE is set
  * @type: crtc resource type
  * @tag: unique identifier per type
  * @refcount: reference/usage count
@@ -368,6 +376,9 @@ struct sde_crtc_res_ops {
  */
 struct sde_crtc_res {
 	struct list_head list;
+	struct hlist_node hnode;
+	struct hlist_node tnode;
+	struct hlist_node fnode;
 	u32 type;
 	u64 tag;
 	atomic_t refcount;
@@ -383,6 +394,9 @@ struct sde_crtc_res {
  * @rp_list: list of crtc resource pool
  * @sequence_id: sequence identifier, incremented per state duplication
  * @res_list: list of resource managed by this resource pool
+ * @res_hash: index of all resources in this pool by type and tag
+ * @type_hash: index of all resources in this pool by type
+ * @free_hash: index of free resources in this pool by type
  * @ops: resource operations for parent resource pool
  */
 struct sde_crtc_respool {
@@ -391,6 +405,9 @@ struct sde_crtc_respool {
 	struct list_head rp_list;
 	u32 sequence_id;
 	struct list_head res_list;
+	DECLARE_HASHTABLE(res_hash, SDE_CRTC_RES_HASH_BITS);
+	DECLARE_HASHTABLE(type_hash, SDE_CRTC_RES_HASH_BITS);
+	DECLARE_HASHTABLE(free_hash, SDE_CRTC_RES_HASH_BITS);
 	struct sde_crtc_res_ops ops;
 };
 
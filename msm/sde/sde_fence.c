@@ -6,6 +6,7 @@
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
 #include <linux/sync_file.h>
 #include <linux/dma-fence.h>
+#include <linux/dma-fence-array.h>
 #include "msm_drv.h"
 #include "sde_kms.h"
 #include "sde_fence.h"
@@ -54,6 +55,62 @@ signed long sde_sync_wait(void *fnc, long timeout_ms)
 	return rc;
 }
 
+signed long sde_sync_wait_multiple(void **fnc, uint32_t count,
+		long timeout_ms, uint32_t *pending)
+{
+	struct dma_fence **fences;
+	struct dma_fence_array *array;
+	uint32_t i, num = 0;
+	signed long rc;
+
+	if (!fnc || !pending)
+		return -EINVAL;
+
+	*pending = 0;
+	for (i = 0; i < count; i++) {
+		if (fnc[i] && !dma_fence_is_signaled(fnc[i]))
+			num++;
+	}
+
+	if (!num)
+		return timeout_ms ? msecs_to_jiffies(timeout_ms) : 1;
+
+	fences = kmalloc_array(num, sizeof(*fences), GFP_KERNEL);
+	if (!fences)
+		return -ENOMEM;
+
+	for (i = 0; i < count && *pending < num; i++) {
+		if (fnc[i] && !dma_fence_is_signaled(fnc[i]))
+			fences[(*pending)++] = dma_fence_get(fnc[i]);
+	}
+
+	if (!*pending) {
+		kfree(fences);
+		return timeout_ms ? msecs_to_jiffies(timeout_ms) : 1;
+	} else if (*pending == 1) {
+		rc = sde_sync_wait(fences[0], timeout_ms);
+		dma_fence_put(fences[0]);
+		kfree(fences);
+		return rc;
+	}
+
+	/* the array takes over the fence references and the fences buffer */
+	array = dma_fence_array_create(*pending, fences,
+			dma_fence_context_alloc(1), 1, false);
+	if (!array) {
+		for (i = 0; i < *pending; i++)
+			dma_fence_put(fences[i]);
+		kfree(fences);
+		return -ENOMEM;
+	}
+
+	rc = dma_fence_wait_timeout(&array->base, true,
+			msecs_to_jiffies(timeout_ms));
+	dma_fence_put(&array->base);
+
+	return rc;
+}
+
 uint32_t sde_sync_get_name_prefix(void *fence)
 {
 	const char *name;
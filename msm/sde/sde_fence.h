@@ -87,6 +87,26 @@ void sde_sync_put(void *fence);
  */
 signed long sde_sync_wait(void *fence, long timeout_ms);
 
+/**
+ * sde_sync_wait_multiple - Wait for all of the given sync fence objects
+ *
+ * Fences that are already signaled are skipped, the remaining ones are
+ * waited on together with a single timeout.
+ *
+ * @fences: Array of pointers to sync fences, NULL entries are ignored
+ * @count: Number of entries in @fences
+ * @timeout_ms: Time to wait, in milliseconds
+ * @pending: Output number of fences that were not signaled before the wait
+ *
+ * Return:
+ * Zero if timed out
+ * -ERESTARTSYS if wait interrupted
+ * -ENOMEM if the combined wait could not be set up
+ * remaining jiffies in all other success cases.
+ */
+signed long sde_sync_wait_multiple(void **fences, uint32_t count,
+		long timeout_ms, uint32_t *pending);
+
 /**
  * sde_sync_get_name_prefix - get integer representation of fence name prefix
  * @fence: Pointer to opaque fence structure
@@ -175,6 +195,14 @@ static inline signed long sde_sync_wait(void *fence, long timeout_ms)
 	return 0;
 }
 
+static inline signed long sde_sync_wait_multiple(void **fences,
+		uint32_t count, long timeout_ms, uint32_t *pending)
+{
+	if (pending)
+		*pending = 0;
+	return 1;
+}
+
 static inline uint32_t sde_sync_get_name_prefix(void *fence)
 {
 	return 0x0;
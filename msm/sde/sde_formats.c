@@ -5,6 +5,7 @@
 
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
 
+#include <linux/hash.h>
 #include <uapi/drm/drm_fourcc.h>
 #include <uapi/media/msm_media_info.h>
 
@@ -642,6 +643,118 @@ static const struct sde_format sde_format_map_tp10_ubwc[] = {
 		SDE_FETCH_UBWC, 4, SDE_TILE_HEIGHT_NV12),
 };
 
+/*
+ * sde_format_modifier_maps - format maps selected by each supported
+ * modifier, used to build the (fourcc, modifier) lookup table
+ */
+static const struct sde_format_modifier_map {
+	uint64_t modifier;
+	const struct sde_format *map;
+	size_t map_size;
+} sde_format_modifier_maps[] = {
+	{ 0,
+		sde_format_map, ARRAY_SIZE(sde_format_map) },
+	{ DRM_FORMAT_MOD_QCOM_COMPRESSED,
+		sde_format_map_ubwc, ARRAY_SIZE(sde_format_map_ubwc) },
+	{ DRM_FORMAT_MOD_QCOM_COMPRESSED | DRM_FORMAT_MOD_QCOM_TILE,
+		sde_format_map_ubwc, ARRAY_SIZE(sde_format_map_ubwc) },
+	{ DRM_FORMAT_MOD_QCOM_DX,
+		sde_format_map_p010, ARRAY_SIZE(sde_format_map_p010) },
+	{ DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED,
+		sde_format_map_p010_ubwc,
+		ARRAY_SIZE(sde_format_map_p010_ubwc) },
+	{ DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED |
+			DRM_FORMAT_MOD_QCOM_TILE,
+		sde_format_map_p010_ubwc,
+		ARRAY_SIZE(sde_format_map_p010_ubwc) },
+	{ DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED |
+			DRM_FORMAT_MOD_QCOM_TIGHT,
+		sde_format_map_tp10_ubwc,
+		ARRAY_SIZE(sde_format_map_tp10_ubwc) },
+	{ DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED |
+			DRM_FORMAT_MOD_QCOM_TIGHT | DRM_FORMAT_MOD_QCOM_TILE,
+		sde_format_map_tp10_ubwc,
+		ARRAY_SIZE(sde_format_map_tp10_ubwc) },
+	{ DRM_FORMAT_MOD_QCOM_TILE,
+		sde_format_map_tile, ARRAY_SIZE(sde_format_map_tile) },
+	{ DRM_FORMAT_MOD_QCOM_TILE | DRM_FORMAT_MOD_QCOM_DX,
+		sde_format_map_p010_tile,
+		ARRAY_SIZE(sde_format_map_p010_tile) },
+	{ DRM_FORMAT_MOD_QCOM_TILE | DRM_FORMAT_MOD_QCOM_DX |
+			DRM_FORMAT_MOD_QCOM_TIGHT,
+		sde_format_map_tp10_tile,
+		ARRAY_SIZE(sde_format_map_tp10_tile) },
+};
+
+/*
+ * Open addressed (fourcc, modifier) -> format table, populated once from
+ * sde_format_modifier_maps. Must be larger than the total number of map
+ * entries; half empty keeps probe sequences short.
+ */
+#define SDE_FORMAT_HASH_BITS	9
+#define SDE_FORMAT_HASH_SIZE	(1 << SDE_FORMAT_HASH_BITS)
+
+static struct sde_format_hash_entry {
+	uint64_t modifier;
+	const struct sde_format *fmt;
+} sde_format_hash[SDE_FORMAT_HASH_SIZE];
+
+static DEFINE_MUTEX(sde_format_hash_lock);
+static bool sde_format_hash_ready;
+
+static inline uint32_t _sde_format_hash_key(uint32_t format,
+		uint64_t modifier)
+{
+	return hash_64(modifier ^ ((uint64_t)format << 8),
+			SDE_FORMAT_HASH_BITS);
+}
+
+static void _sde_format_hash_init(void)
+{
+	const struct sde_format_modifier_map *mod_map;
+	struct sde_format_hash_entry *entry;
+	uint32_t i, j, key, probe;
+
+	mutex_lock(&sde_format_hash_lock);
+	if (sde_format_hash_ready)
+		goto exit;
+
+	for (i = 0; i < ARRAY_SIZE(sde_format_modifier_maps); i++) {
+		mod_map = &sde_format_modifier_maps[i];
+		for (j = 0; j < mod_map->map_size; j++) {
+			key = _sde_format_hash_key(
+					mod_map->map[j].base.pixel_format,
+					mod_map->modifier);
+
+			for (probe = 0; probe < SDE_FORMAT_HASH_SIZE; probe++) {
+				entry = &sde_format_hash[(key + probe) &
+						(SDE_FORMAT_HASH_SIZE - 1)];
+				if (!entry->fmt)
+					break;
+
+				/* keep first match, as the linear scan did */
+				if (entry->modifier == mod_map->modifier &&
+						entry->fmt->base.pixel_format ==
+						mod_map->map[j].base.pixel_format)
+					break;
+			}
+
+			if (WARN_ON(probe == SDE_FORMAT_HASH_SIZE))
+				goto exit;
+
+			if (!entry->fmt) {
+				entry->modifier = mod_map->modifier;
+				entry->fmt = &mod_map->map[j];
+			}
+		}
+	}
+
+	/* publish the table to lock-free readers */
+	smp_store_release(&sde_format_hash_ready, true);
+exit:
+	mutex_unlock(&sde_format_hash_lock);
+}
+
 bool sde_format_is_tp10_ubwc(const struct sde_format *fmt)
 {
 	if (SDE_FORMAT_IS_YUV(fmt) && SDE_FORMAT_IS_DX(fmt) &&
@@ -714,6 +827,68 @@ static int _sde_format_get_media_color_ubwc(const struct sde_format *fmt)
 	return color_fmt;
 }
 
+/*
+ * Small LRU of ubwc/tile plane layouts keyed by format and dimensions, the
+ * format pointer already tells the modifier apart. The venus stride and
+ * scanline alignment is redone for the same few framebuffers on every
+ * atomic check and commit otherwise.
+ */
+#define SDE_FORMAT_LAYOUT_CACHE_SIZE	8
+
+struct sde_format_layout_cache_entry {
+	struct list_head list;
+	struct sde_hw_fmt_layout layout;
+};
+
+static struct sde_format_layout_cache_entry
+		sde_format_layout_cache[SDE_FORMAT_LAYOUT_CACHE_SIZE];
+static LIST_HEAD(sde_format_layout_lru);
+static u32 sde_format_layout_cache_count;
+static DEFINE_SPINLOCK(sde_format_layout_lock);
+
+static bool _sde_format_layout_cache_get(const struct sde_format *fmt,
+		uint32_t width, uint32_t height,
+		struct sde_hw_fmt_layout *layout)
+{
+	struct sde_format_layout_cache_entry *entry;
+	bool found = false;
+
+	spin_lock(&sde_format_layout_lock);
+	list_for_each_entry(entry, &sde_format_layout_lru, list) {
+		if (entry->layout.format == fmt &&
+				entry->layout.width == width &&
+				entry->layout.height == height) {
+			list_move(&entry->list, &sde_format_layout_lru);
+			*layout = entry->layout;
+			found = true;
+			break;
+		}
+	}
+	spin_unlock(&sde_format_layout_lock);
+
+	return found;
+}
+
+static void _sde_format_layout_cache_put(
+		const struct sde_hw_fmt_layout *layout)
+{
+	struct sde_format_layout_cache_entry *entry;
+
+	spin_lock(&sde_format_layout_lock);
+	if (sde_format_layout_cache_count < SDE_FORMAT_LAYOUT_CACHE_SIZE) {
+		entry = &sde_format_layout_cache[
+				sde_format_layout_cache_count++];
+		list_add(&entry->list, &sde_format_layout_lru);
+	} else {
+		/* recycle the least recently used layout */
+		entry = list_last_entry(&sde_format_layout_lru,
+				struct sde_format_layout_cache_entry, list);
+		list_move(&entry->list, &sde_format_layout_lru);
+	}
+	entry->layout = *layout;
+	spin_unlock(&sde_format_layout_lock);
+}
+
 static int _sde_format_get_plane_sizes_ubwc(
 		const struct sde_format *fmt,
 		const uint32_t width,
@@ -882,8 +1057,18 @@ int sde_format_get_plane_sizes(
 		return -ERANGE;
 	}
 
-	if (SDE_FORMAT_IS_UBWC(fmt) || SDE_FORMAT_IS_TILE(fmt))
-		return _sde_format_get_plane_sizes_ubwc(fmt, w, h, layout);
+	if (SDE_FORMAT_IS_UBWC(fmt) || SDE_FORMAT_IS_TILE(fmt)) {
+		int ret;
+
+		if (_sde_format_layout_cache_get(fmt, w, h, layout))
+			return 0;
+
+		ret = _sde_format_get_plane_sizes_ubwc(fmt, w, h, layout);
+		if (!ret)
+			_sde_format_layout_cache_put(layout);
+
+		return ret;
+	}
 
 	return _sde_format_get_plane_sizes_linear(fmt, w, h, layout, pitches);
 }
@@ -1208,96 +1393,32 @@ const struct sde_format *sde_get_sde_format_ext(
 		const uint32_t format,
 		const uint64_t modifier)
 {
-	uint32_t i = 0;
-	const struct sde_format *fmt = NULL;
-	const struct sde_format *map = NULL;
-	ssize_t map_size = 0;
+	const struct sde_format_hash_entry *entry;
+	uint32_t key, probe;
+
+	if (!smp_load_acquire(&sde_format_hash_ready))
+		_sde_format_hash_init();
 
 	/*
 	 * Currently only support exactly zero or one modifier.
 	 * All planes use the same modifier.
 	 */
-	SDE_DEBUG("plane format modifier 0x%llX\n", modifier);
-
-	switch (modifier) {
-	case 0:
-		map = sde_format_map;
-		map_size = ARRAY_SIZE(sde_format_map);
-		break;
-	case DRM_FORMAT_MOD_QCOM_COMPRESSED:
-	case DRM_FORMAT_MOD_QCOM_COMPRESSED | DRM_FORMAT_MOD_QCOM_TILE:
-		map = sde_format_map_ubwc;
-		map_size = ARRAY_SIZE(sde_format_map_ubwc);
-		SDE_DEBUG("found fmt: %4.4s  DRM_FORMAT_MOD_QCOM_COMPRESSED\n",
-				(char *)&format);
-		break;
-	case DRM_FORMAT_MOD_QCOM_DX:
-		map = sde_format_map_p010;
-		map_size = ARRAY_SIZE(sde_format_map_p010);
-		SDE_DEBUG("found fmt: %4.4s DRM_FORMAT_MOD_QCOM_DX\n",
-				(char *)&format);
-		break;
-	case (DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED):
-	case (DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED |
-			DRM_FORMAT_MOD_QCOM_TILE):
-		map = sde_format_map_p010_ubwc;
-		map_size = ARRAY_SIZE(sde_format_map_p010_ubwc);
-		SDE_DEBUG(
-			"found fmt: %4.4s DRM_FORMAT_MOD_QCOM_COMPRESSED/DX\n",
-				(char *)&format);
-		break;
-	case (DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED |
-		DRM_FORMAT_MOD_QCOM_TIGHT):
-	case (DRM_FORMAT_MOD_QCOM_DX | DRM_FORMAT_MOD_QCOM_COMPRESSED |
-		DRM_FORMAT_MOD_QCOM_TIGHT | DRM_FORMAT_MOD_QCOM_TILE):
-		map = sde_format_map_tp10_ubwc;
-		map_size = ARRAY_SIZE(sde_format_map_tp10_ubwc);
-		SDE_DEBUG(
-			"found fmt: %4.4s DRM_FORMAT_MOD_QCOM_COMPRESSED/DX/TIGHT\n",
-				(char *)&format);
-		break;
-	case DRM_FORMAT_MOD_QCOM_TILE:
-		map = sde_format_map_tile;
-		map_size = ARRAY_SIZE(sde_format_map_tile);
-		SDE_DEBUG("found fmt: %4.4s DRM_FORMAT_MOD_QCOM_TILE\n",
-				(char *)&format);
-		break;
-	case (DRM_FORMAT_MOD_QCOM_TILE | DRM_FORMAT_MOD_QCOM_DX):
-		map = sde_format_map_p010_tile;
-		map_size = ARRAY_SIZE(sde_format_map_p010_tile);
-		SDE_DEBUG("found fmt: %4.4s DRM_FORMAT_MOD_QCOM_TILE/DX\n",
-				(char *)&format);
-		break;
-	case (DRM_FORMAT_MOD_QCOM_TILE | DRM_FORMAT_MOD_QCOM_DX |
-			DRM_FORMAT_MOD_QCOM_TIGHT):
-		map = sde_format_map_tp10_tile;
-		map_size = ARRAY_SIZE(sde_format_map_tp10_tile);
-		SDE_DEBUG(
-			"found fmt: %4.4s DRM_FORMAT_MOD_QCOM_TILE/DX/TIGHT\n",
-				(char *)&format);
-		break;
-	default:
-		SDE_ERROR("unsupported format modifier %llX\n", modifier);
-		return NULL;
-	}
-
-	for (i = 0; i < map_size; i++) {
-		if (format == map[i].base.pixel_format) {
-			fmt = &map[i];
+	key = _sde_format_hash_key(format, modifier);
+	for (probe = 0; probe < SDE_FORMAT_HASH_SIZE; probe++) {
+		entry = &sde_format_hash[(key + probe) &
+				(SDE_FORMAT_HASH_SIZE - 1)];
+		if (!entry->fmt)
 			break;
-		}
+
+		if (entry->modifier == modifier &&
+				entry->fmt->base.pixel_format == format)
+			return entry->fmt;
 	}
 
-	if (fmt == NULL)
-		SDE_ERROR("unsupported fmt: %4.4s modifier 0x%llX\n",
-				(char *)&format, modifier);
-	else
-		SDE_DEBUG("fmt %4.4s mod 0x%llX ubwc %d yuv %d\n",
-				(char *)&format, modifier,
-				SDE_FORMAT_IS_UBWC(fmt),
-				SDE_FORMAT_IS_YUV(fmt));
+	SDE_ERROR("unsupported fmt: %4.4s modifier 0x%llX\n",
+			(char *)&format, modifier);
 
-	return fmt;
+	return NULL;
 }
 
 const struct msm_format *sde_get_msm_format(
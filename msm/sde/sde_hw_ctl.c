@@ -59,6 +59,33 @@
 #define UPDATE_MASK(m, idx, en)           \
 	((m) = (en) ? ((m) | BIT((idx))) : ((m) & ~BIT((idx))))
 
+/* per frame register record, bounded by the max dwords of one kick off */
+#define CTL_REG_REC_MAX                 2048
+#define CTL_REG_REC_BUF_SZ              (CTL_REG_REC_MAX * sizeof(u32) * 3)
+
+/*
+ * reg_dma_frame - send the per frame sspp, mixer and blend stage
+ *	programming by reg dma ahead of the ctl flush, instead of writing
+ *	each register over ahb. This is disabled by default.
+ */
+static bool reg_dma_frame;
+module_param(reg_dma_frame, bool, 0400);
+MODULE_PARM_DESC(reg_dma_frame, "Program per frame sde registers by reg dma");
+
+/**
+ * List of layer mixing and path configuration registers cached by reg
+ * shadow. Flush, start, prepare and reset registers are left out.
+ */
+static const struct sde_hw_reg_range ctl_shadow_regs[] = {
+	{CTL_LAYER(LM_0), CTL_TOP + 0x4},
+	{CTL_LAYER(LM_5), 0x4},
+	{CTL_LAYER_EXT(LM_0), 0x18},
+	{CTL_LAYER_EXT2(LM_0), 0x18},
+	{CTL_LAYER_EXT3(LM_0), 0x18},
+	{CTL_MERGE_3D_ACTIVE, CTL_CDM_ACTIVE + 0x4 - CTL_MERGE_3D_ACTIVE},
+	{CTL_INTF_MASTER, 0x4},
+};
+
 /**
  * List of SSPP bits in CTL_FLUSH
  */
@@ -712,6 +739,9 @@ static int sde_hw_ctl_reset_control(struct sde_hw_ctl *ctx)
 	c = &ctx->hw;
 	pr_debug("issuing hw ctl reset for ctl:%d\n", ctx->idx);
 	SDE_REG_WRITE(c, CTL_SW_RESET, 0x1);
+
+	/* the reset also clears the blocks on this path */
+	sde_hw_reg_shadow_invalidate_all();
 	if (sde_hw_ctl_poll_reset_status(ctx, SDE_REG_RESET_TIMEOUT_US))
 		return -EINVAL;
 
@@ -729,6 +759,8 @@ static void sde_hw_ctl_hard_reset(struct sde_hw_ctl *ctx, bool enable)
 	pr_debug("hw ctl hard reset for ctl:%d, %d\n",
 			ctx->idx - CTL_0, enable);
 	SDE_REG_WRITE(c, CTL_SW_RESET_OVERRIDE, enable);
+	if (enable)
+		sde_hw_reg_shadow_invalidate_all();
 }
 
 static int sde_hw_ctl_wait_reset_status(struct sde_hw_ctl *ctx)
@@ -1243,6 +1275,122 @@ static int sde_hw_reg_dma_flush(struct sde_hw_ctl *ctx, bool blocking)
 
 }
 
+static int sde_hw_ctl_reg_rec_begin(struct sde_hw_ctl *ctx)
+{
+	struct sde_hw_reg_dma_ops *dma_ops;
+	bool supported = false;
+
+	if (!ctx)
+		return -EINVAL;
+
+	if (!reg_dma_frame)
+		return -ENOTSUPP;
+
+	if (!ctx->rec) {
+		dma_ops = sde_reg_dma_get_ops();
+		if (IS_ERR_OR_NULL(dma_ops) || !dma_ops->check_support ||
+				dma_ops->check_support(FRAME_REG_PROG, MDSS,
+					&supported) || !supported)
+			return -ENOTSUPP;
+
+		ctx->rec_buf = dma_ops->alloc_reg_dma_buf(CTL_REG_REC_BUF_SZ);
+		if (IS_ERR_OR_NULL(ctx->rec_buf)) {
+			ctx->rec_buf = NULL;
+			return -ENOMEM;
+		}
+
+		ctx->rec = sde_hw_reg_rec_create(ctx->hw.base_off,
+				CTL_REG_REC_MAX);
+		if (!ctx->rec) {
+			dma_ops->dealloc_reg_dma(ctx->rec_buf);
+			ctx->rec_buf = NULL;
+			return -ENOMEM;
+		}
+	}
+
+	/* writes of a frame that was never kicked off */
+	sde_hw_reg_rec_replay(ctx->rec);
+	ctx->rec->active = true;
+
+	return 0;
+}
+
+static int _sde_hw_ctl_reg_rec_kickoff(struct sde_hw_ctl *ctx)
+{
+	struct sde_hw_reg_dma_ops *dma_ops = sde_reg_dma_get_ops();
+	struct sde_hw_reg_rec *rec = ctx->rec;
+	struct sde_reg_dma_setup_ops_cfg cfg;
+	struct sde_reg_dma_kickoff_cfg kick_off;
+	u32 i, j;
+	int rc;
+
+	if (IS_ERR_OR_NULL(dma_ops))
+		return -ENOTSUPP;
+
+	dma_ops->reset_reg_dma_buf(ctx->rec_buf);
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.ops = HW_BLK_SELECT;
+	cfg.blk = MDSS;
+	cfg.feature = FRAME_REG_PROG;
+	cfg.dma_buf = ctx->rec_buf;
+	rc = dma_ops->setup_payload(&cfg);
+	if (rc)
+		return rc;
+
+	/* consecutive registers, e.g. the rect sizes, go out as one burst */
+	for (i = 0; i < rec->count; i = j) {
+		for (j = i + 1; j < rec->count; j++)
+			if (rec->off[j] != rec->off[j - 1] + sizeof(u32))
+				break;
+
+		cfg.ops = (j - i > 1) ? REG_BLK_WRITE_SINGLE :
+				REG_SINGLE_WRITE;
+		cfg.blk_offset = rec->off[i];
+		cfg.data = &rec->val[i];
+		cfg.data_size = (j - i) * sizeof(u32);
+		rc = dma_ops->setup_payload(&cfg);
+		if (rc)
+			return rc;
+	}
+
+	memset(&kick_off, 0, sizeof(kick_off));
+	kick_off.ctl = ctx;
+	kick_off.op = REG_DMA_WRITE;
+	kick_off.dma_buf = ctx->rec_buf;
+	kick_off.queue_select = DMA_CTL_QUEUE0;
+	kick_off.trigger_mode = WRITE_IMMEDIATE;
+
+	return dma_ops->kick_off(&kick_off);
+}
+
+static int sde_hw_ctl_reg_rec_end(struct sde_hw_ctl *ctx, bool kickoff)
+{
+	int rc = 0;
+
+	if (!ctx || !ctx->rec || !ctx->rec->active)
+		return 0;
+
+	ctx->rec->active = false;
+	if (!ctx->rec->count)
+		return 0;
+
+	SDE_EVT32(ctx->idx, ctx->rec->count, kickoff);
+
+	if (kickoff) {
+		rc = _sde_hw_ctl_reg_rec_kickoff(ctx);
+		if (rc)
+			SDE_ERROR("ctl %d reg dma kickoff failed %d\n",
+					ctx->idx - CTL_0, rc);
+		else
+			ctx->rec->count = 0;
+	}
+
+	sde_hw_reg_rec_replay(ctx->rec);
+
+	return rc;
+}
+
 static void _setup_ctl_ops(struct sde_hw_ctl_ops *ops,
 		unsigned long cap)
 {
@@ -1297,6 +1445,8 @@ static void _setup_ctl_ops(struct sde_hw_ctl_ops *ops,
 	ops->update_bitmask_dspp = sde_hw_ctl_update_bitmask_dspp;
 	ops->update_bitmask_dspp_pavlut = sde_hw_ctl_update_bitmask_dspp_pavlut;
 	ops->reg_dma_flush = sde_hw_reg_dma_flush;
+	ops->reg_rec_begin = sde_hw_ctl_reg_rec_begin;
+	ops->reg_rec_end = sde_hw_ctl_reg_rec_end;
 	ops->get_start_state = sde_hw_ctl_get_start_state;
 	if (cap & BIT(SDE_CTL_SBUF)) {
 		ops->update_bitmask_rot = sde_hw_ctl_update_bitmask_rot;
@@ -1341,6 +1491,12 @@ struct sde_hw_ctl *sde_hw_ctl_init(enum sde_ctl idx,
 		goto blk_init_error;
 	}
 
+	if (sde_hw_reg_shadow_init(&c->hw))
+		SDE_ERROR("failed to init reg shadow for ctl %d\n", idx);
+
+	sde_hw_reg_shadow_allow(&c->hw, 0, ctl_shadow_regs,
+			ARRAY_SIZE(ctl_shadow_regs));
+
 	sde_dbg_reg_register_dump_range(SDE_DBG_NAME, cfg->name, c->hw.blk_off,
 			c->hw.blk_off + c->hw.length, c->hw.xin_id);
 
@@ -1354,7 +1510,17 @@ blk_init_error:
 
 void sde_hw_ctl_destroy(struct sde_hw_ctl *ctx)
 {
-	if (ctx)
+	struct sde_hw_reg_dma_ops *dma_ops;
+
+	if (ctx) {
+		if (ctx->rec_buf) {
+			dma_ops = sde_reg_dma_get_ops();
+			if (!IS_ERR_OR_NULL(dma_ops) && dma_ops->dealloc_reg_dma)
+				dma_ops->dealloc_reg_dma(ctx->rec_buf);
+		}
+		sde_hw_reg_rec_destroy(ctx->rec);
+		sde_hw_reg_shadow_destroy(&ctx->hw);
 		sde_hw_blk_destroy(&ctx->base);
+	}
 	kfree(ctx);
 }
@@ -12,6 +12,8 @@
 #include "sde_hw_sspp.h"
 #include "sde_hw_blk.h"
 
+struct sde_reg_dma_buffer;
+
 /**
  * sde_ctl_mode_sel: Interface mode selection
  * SDE_CTL_MODE_SEL_VID:    Video mode interface
@@ -469,6 +471,25 @@ struct sde_hw_ctl_ops {
 	 */
 	int (*reg_dma_flush)(struct sde_hw_ctl *ctx, bool blocking);
 
+	/**
+	 * Start holding back the register writes of the register maps
+	 * attached to the ctl's register record, to send them by reg dma
+	 * @ctx       : ctl path ctx pointer
+	 * @Return: 0 if recording, -ENOTSUPP or error code otherwise
+	 */
+	int (*reg_rec_begin)(struct sde_hw_ctl *ctx);
+
+	/**
+	 * Stop recording and queue the recorded writes on the ctl's reg dma
+	 * queue, to be triggered with reg_dma_flush ahead of the ctl flush.
+	 * The writes go out over ahb instead if @kickoff is false or the reg
+	 * dma buffer can't be programmed.
+	 * @ctx       : ctl path ctx pointer
+	 * @kickoff   : send the recorded writes by reg dma
+	 * @Return: error code
+	 */
+	int (*reg_rec_end)(struct sde_hw_ctl *ctx, bool kickoff);
+
 	/**
 	 * check if ctl start trigger state to confirm the frame pending
 	 * status
@@ -487,6 +508,8 @@ struct sde_hw_ctl_ops {
  * @mixer_count: number of mixers
  * @mixer_hw_caps: mixer hardware capabilities
  * @flush: storage for pending ctl_flush managed via ops
+ * @rec: per frame register record, allocated on the first reg_rec_begin
+ * @rec_buf: reg dma buffer the register record is sent with
  * @ops: operation list
  */
 struct sde_hw_ctl {
@@ -499,6 +522,8 @@ struct sde_hw_ctl {
 	int mixer_count;
 	const struct sde_lm_cfg *mixer_hw_caps;
 	struct sde_ctl_flush_cfg flush;
+	struct sde_hw_reg_rec *rec;
+	struct sde_reg_dma_buffer *rec_buf;
 
 	/* ops */
 	struct sde_hw_ctl_ops ops;
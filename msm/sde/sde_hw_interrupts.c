@@ -1148,70 +1148,47 @@ static void sde_hw_intr_dispatch_irq(struct sde_hw_intr *intr,
 {
 	int reg_idx;
 	int irq_idx;
-	int start_idx;
-	int end_idx;
+	int bit;
 	u32 irq_status;
 	unsigned long irq_flags;
-	int sde_irq_idx;
+	const int *bit_tbl;
 
 	if (!intr)
 		return;
 
 	/*
 	 * The dispatcher will save the IRQ status before calling here.
-	 * Now need to go through each IRQ status and find matching
-	 * irq lookup index.
+	 * Now need to go through each set bit of the IRQ status and look
+	 * up its irq index in the table built at init time.
 	 */
 	spin_lock_irqsave(&intr->irq_lock, irq_flags);
 	for (reg_idx = 0; reg_idx < intr->sde_irq_size; reg_idx++) {
 		irq_status = intr->save_irq_status[reg_idx];
-
-		/* get the global offset in 'sde_irq_map' */
-		sde_irq_idx = intr->sde_irq_tbl[reg_idx].sde_irq_idx;
-		if (sde_irq_idx < 0)
-			continue;
-
-		/*
-		 * Each Interrupt register has a range of 32 indexes, and
-		 * that is static for sde_irq_map.
-		 */
-		start_idx = sde_irq_idx * 32;
-		end_idx = start_idx + 32;
-
-		if (start_idx >= ARRAY_SIZE(sde_irq_map) ||
-				end_idx > ARRAY_SIZE(sde_irq_map))
-			continue;
-
-		/*
-		 * Search through matching intr status from irq map.
-		 * start_idx and end_idx defined the search range in
-		 * the sde_irq_map.
-		 */
-		for (irq_idx = start_idx;
-				(irq_idx < end_idx) && irq_status;
-				irq_idx++)
-			if ((irq_status & sde_irq_map[irq_idx].irq_mask) &&
-				(sde_irq_map[irq_idx].reg_idx == reg_idx)) {
-				/*
-				 * Once a match on irq mask, perform a callback
-				 * to the given cbfunc. cbfunc will take care
-				 * the interrupt status clearing. If cbfunc is
-				 * not provided, then the interrupt clearing
-				 * is here.
-				 */
-				if (cbfunc)
-					cbfunc(arg, irq_idx);
-				else
-					intr->ops.clear_intr_status_nolock(
-							intr, irq_idx);
-
-				/*
-				 * When callback finish, clear the irq_status
-				 * with the matching mask. Once irq_status
-				 * is all cleared, the search can be stopped.
-				 */
-				irq_status &= ~sde_irq_map[irq_idx].irq_mask;
+		bit_tbl = &intr->irq_bit_tbl[reg_idx * 32];
+
+		while (irq_status) {
+			bit = __ffs(irq_status);
+			irq_idx = bit_tbl[bit];
+			if (irq_idx < 0) {
+				irq_status &= ~BIT(bit);
+				continue;
 			}
+
+			/*
+			 * Perform a callback to the given cbfunc. cbfunc will
+			 * take care the interrupt status clearing. If cbfunc
+			 * is not provided, then the interrupt clearing is
+			 * here.
+			 */
+			if (cbfunc)
+				cbfunc(arg, irq_idx);
+			else
+				intr->ops.clear_intr_status_nolock(
+						intr, irq_idx);
+
+			irq_status &= ~(sde_irq_map[irq_idx].irq_mask |
+					BIT(bit));
+		}
 	}
 	spin_unlock_irqrestore(&intr->irq_lock, irq_flags);
 }
@@ -1794,6 +1771,7 @@ void sde_hw_intr_destroy(struct sde_hw_intr *intr)
 {
 	if (intr) {
 		kfree(intr->sde_irq_tbl);
+		kfree(intr->irq_bit_tbl);
 		kfree(intr->cache_irq_mask);
 		kfree(intr->save_irq_status);
 		kfree(intr);
@@ -1803,8 +1781,10 @@ void sde_hw_intr_destroy(struct sde_hw_intr *intr)
 static int _sde_hw_intr_init_irq_tables(struct sde_hw_intr *intr,
 	struct sde_mdss_cfg *m)
 {
-	int i, idx, sde_idx = 0, ret = 0;
+	int i, bit, idx, sde_idx = 0, ret = 0;
 	u32 low_idx, high_idx;
+	unsigned long mask;
+	int *bit_tbl;
 
 	/* Initialize the offset of the irq's in the 'sde_irq_map' table */
 	for (idx = 0; idx < MDSS_INTR_MAX; idx++) {
@@ -1823,10 +1803,23 @@ static int _sde_hw_intr_init_irq_tables(struct sde_hw_intr *intr,
 				goto exit;
 			}
 
-			/* Init the mapping */
-			for (i = low_idx; i < high_idx; i++)
+			/*
+			 * Init the mapping, the first irq_idx claiming a status
+			 * bit owns it for dispatch.
+			 */
+			bit_tbl = &intr->irq_bit_tbl[sde_idx * 32];
+			for (i = 0; i < 32; i++)
+				bit_tbl[i] = -1;
+
+			for (i = low_idx; i < high_idx; i++) {
 				sde_irq_map[i].reg_idx = sde_idx;
 
+				mask = sde_irq_map[i].irq_mask;
+				for_each_set_bit(bit, &mask, 32)
+					if (bit_tbl[bit] < 0)
+						bit_tbl[bit] = i;
+			}
+
 			/* Keep track of which irq enum we are in the table */
 			intr->sde_irq_tbl[sde_idx].sde_irq_idx = idx;
 
@@ -1893,6 +1886,12 @@ struct sde_hw_intr *sde_hw_intr_init(void __iomem *addr,
 		goto exit;
 	}
 
+	intr->irq_bit_tbl = kcalloc(count * 32, sizeof(int), GFP_KERNEL);
+	if (intr->irq_bit_tbl == NULL) {
+		ret = -ENOMEM;
+		goto exit;
+	}
+
 	ret = _sde_hw_intr_init_irq_tables(intr, m);
 	if (ret)
 		goto exit;
@@ -1917,6 +1916,7 @@ struct sde_hw_intr *sde_hw_intr_init(void __iomem *addr,
 
 exit:
 	kfree(intr->sde_irq_tbl);
+	kfree(intr->irq_bit_tbl);
 	kfree(intr->cache_irq_mask);
 	kfree(intr->save_irq_status);
 	kfree(intr);
@@ -293,6 +293,8 @@ struct sde_hw_intr_ops {
  * @sde_irq_size:   total number of elements of the sde_irq_tbl
  * @sde_irq_tbl:	table with the registesrs offsets of the sde interrupts
  *		supported by the hw
+ * @irq_bit_tbl:      irq_idx of each status bit, 32 entries per sde_irq_tbl
+ *		register, -1 if the bit is not mapped
  */
 struct sde_hw_intr {
 	struct sde_hw_blk_reg_map hw;
@@ -302,6 +304,7 @@ struct sde_hw_intr {
 	u32 irq_idx_tbl_size;
 	u32 sde_irq_size;
 	struct sde_intr_reg *sde_irq_tbl;
+	int *irq_bit_tbl;
 	spinlock_t irq_lock;
 };
 
@@ -30,6 +30,18 @@
 #define LM_MISR_CTRL			0x310
 #define LM_MISR_SIGNATURE		0x314
 
+/* Configuration registers cached by reg shadow, MISR is left out */
+static const struct sde_hw_reg_range lm_shadow_regs[] = {
+	{LM_OP_MODE, 0x8},
+	{LM_BORDER_COLOR_0, 0x4},
+	{LM_BORDER_COLOR_1, 0x4},
+};
+
+/* Blend and color fill registers, relative to each blend stage */
+static const struct sde_hw_reg_range lm_stage_shadow_regs[] = {
+	{LM_BLEND0_OP, LM_FG_COLOR_FILL_XY + 0x4},
+};
+
 static struct sde_lm_cfg *_lm_offset(enum sde_lm mixer,
 		struct sde_mdss_cfg *m,
 		void __iomem *addr,
@@ -292,6 +304,7 @@ struct sde_hw_mixer *sde_hw_lm_init(enum sde_lm idx,
 	struct sde_hw_mixer *c;
 	struct sde_lm_cfg *cfg;
 	int rc;
+	u32 i;
 
 	c = kzalloc(sizeof(*c), GFP_KERNEL);
 	if (!c)
@@ -314,6 +327,16 @@ struct sde_hw_mixer *sde_hw_lm_init(enum sde_lm idx,
 		goto blk_init_error;
 	}
 
+	if (sde_hw_reg_shadow_init(&c->hw))
+		SDE_ERROR("failed to init reg shadow for lm %d\n", idx);
+
+	sde_hw_reg_shadow_allow(&c->hw, 0, lm_shadow_regs,
+			ARRAY_SIZE(lm_shadow_regs));
+	for (i = 0; i < cfg->sblk->maxblendstages && i < MAX_BLOCKS; i++)
+		sde_hw_reg_shadow_allow(&c->hw, cfg->sblk->blendstage_base[i],
+				lm_stage_shadow_regs,
+				ARRAY_SIZE(lm_stage_shadow_regs));
+
 	sde_dbg_reg_register_dump_range(SDE_DBG_NAME, cfg->name, c->hw.blk_off,
 			c->hw.blk_off + c->hw.length, c->hw.xin_id);
 
@@ -327,7 +350,9 @@ blk_init_error:
 
 void sde_hw_lm_destroy(struct sde_hw_mixer *lm)
 {
-	if (lm)
+	if (lm) {
+		sde_hw_reg_shadow_destroy(&lm->hw);
 		sde_hw_blk_destroy(&lm->base);
+	}
 	kfree(lm);
 }
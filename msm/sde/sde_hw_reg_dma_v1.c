@@ -210,6 +210,10 @@ static void get_decode_sel(unsigned long blk, u32 *decode_sel)
 			break;
 		}
 	}
+
+	/* offsets are relative to the mdss base when mdss is selected */
+	if (blk & MDSS)
+		*decode_sel |= BIT(31);
 }
 
 static int write_multi_reg(struct sde_reg_dma_setup_ops_cfg *cfg)
@@ -398,6 +402,12 @@ static int validate_write_decode_sel(struct sde_reg_dma_setup_ops_cfg *cfg)
 		return -EINVAL;
 	}
 
+	/* MDSS can't be combined with any other block */
+	if ((cfg->blk & MDSS) && (cfg->blk & ~MDSS)) {
+		DRM_ERROR("invalid blk combination %x\n", cfg->blk);
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
@@ -648,6 +658,7 @@ int init_v11(struct sde_hw_reg_dma *cfg)
 	v1_supported[MEMC_FOLIAGE] = GRP_DSPP_HW_BLK_SELECT;
 	v1_supported[MEMC_PROT] = GRP_DSPP_HW_BLK_SELECT;
 	v1_supported[QSEED] = GRP_VIG_HW_BLK_SELECT;
+	v1_supported[FRAME_REG_PROG] = MDSS;
 
 	return 0;
 }
@@ -661,7 +672,8 @@ static int check_support_v1(enum sde_reg_dma_features feature,
 	if (!is_supported)
 		return -EINVAL;
 
-	if (feature >= REG_DMA_FEATURES_MAX || blk >= MDSS) {
+	if (feature >= REG_DMA_FEATURES_MAX ||
+			((blk & MDSS) && blk != MDSS)) {
 		*is_supported = false;
 		return ret;
 	}
@@ -52,6 +52,9 @@
 			(450 * sizeof(u32)) + \
 			REG_DMA_HEADERS_BUFFER_SZ)
 
+/* frame scoped dspp batch, bounded by the max dwords of one kick off */
+#define REG_DMA_DSPP_BATCH_MEM_SIZE (SZ_64K - SZ_256)
+
 #define REG_MASK(n) ((BIT(n)) - 1)
 #define REG_MASK_SHIFT(n, shift) ((REG_MASK(n)) << (shift))
 #define REG_DMA_VIG_GAMUT_OP_MASK 0x300
@@ -84,6 +87,24 @@ static struct sde_reg_dma_buffer *dspp_buf[REG_DMA_FEATURES_MAX][DSPP_MAX];
 static struct sde_reg_dma_buffer
 	*sspp_buf[SDE_SSPP_RECT_MAX][REG_DMA_FEATURES_MAX][SSPP_MAX];
 
+/**
+ * struct reg_dma_dspp_batch - frame scoped reg dma batch of a ctl
+ * @buf: buffer all dspp features of the ctl append to
+ * @active: whether dspp features are being batched for the ctl
+ * @index: buffer index after the last fully programmed feature
+ * @ops_completed: buffer ops_completed after the last programmed feature
+ * @next_op_allowed: buffer next_op_allowed after the last programmed feature
+ */
+struct reg_dma_dspp_batch {
+	struct sde_reg_dma_buffer *buf;
+	bool active;
+	u32 index;
+	u32 ops_completed;
+	u32 next_op_allowed;
+};
+
+static struct reg_dma_dspp_batch dspp_batch[CTL_MAX];
+
 static u32 feature_map[SDE_DSPP_MAX] = {
 	[SDE_DSPP_VLUT] = VLUT,
 	[SDE_DSPP_GAMUT] = GAMUT,
@@ -201,8 +222,10 @@ static int reg_dma_buf_init(struct sde_reg_dma_buffer **buf, u32 size)
 		return 0;
 
 	*buf = dma_ops->alloc_reg_dma_buf(size);
-	if (IS_ERR_OR_NULL(*buf))
+	if (IS_ERR_OR_NULL(*buf)) {
+		*buf = NULL;
 		return -EINVAL;
+	}
 
 	return 0;
 }
@@ -237,6 +260,162 @@ static int reg_dma_dspp_check(struct sde_hw_dspp *ctx, void *cfg,
 	return 0;
 }
 
+static void _reg_dma_dspp_batch_mark(struct reg_dma_dspp_batch *batch)
+{
+	batch->index = batch->buf->index;
+	batch->ops_completed = batch->buf->ops_completed;
+	batch->next_op_allowed = batch->buf->next_op_allowed;
+}
+
+static void _reg_dma_dspp_batch_rollback(struct reg_dma_dspp_batch *batch)
+{
+	batch->buf->index = batch->index;
+	batch->buf->ops_completed = batch->ops_completed;
+	batch->buf->next_op_allowed = batch->next_op_allowed;
+}
+
+static int _reg_dma_dspp_batch_flush(struct sde_hw_ctl *ctl,
+		struct reg_dma_dspp_batch *batch)
+{
+	struct sde_hw_reg_dma_ops *dma_ops;
+	struct sde_reg_dma_kickoff_cfg kick_off;
+	int rc = 0;
+
+	dma_ops = sde_reg_dma_get_ops();
+	_reg_dma_dspp_batch_rollback(batch);
+	if (batch->index) {
+		REG_DMA_SETUP_KICKOFF(kick_off, ctl, batch->buf,
+			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
+		rc = dma_ops->kick_off(&kick_off);
+		if (rc)
+			DRM_ERROR("failed to kick off batch ret %d\n", rc);
+	}
+
+	dma_ops->reset_reg_dma_buf(batch->buf);
+	_reg_dma_dspp_batch_mark(batch);
+
+	return rc;
+}
+
+/**
+ * _reg_dma_dspp_get_buf - get the buffer a dspp feature is programmed into
+ * @ctl: ctl the feature is kicked off on
+ * @feature: reg dma feature
+ * @idx: dspp index
+ *
+ * Returns the ctl batch buffer while batching is active and the feature fits
+ * in what is left of it, otherwise the reset per feature buffer. The batch is
+ * only queued once at the end of the frame, so a feature that does not fit is
+ * kicked off on its own rather than reusing the batch buffer. Writes left in
+ * the batch by a feature that bailed out before its kick off are dropped here.
+ */
+static struct sde_reg_dma_buffer *_reg_dma_dspp_get_buf(struct sde_hw_ctl *ctl,
+		enum sde_reg_dma_features feature, enum sde_dspp idx)
+{
+	struct sde_hw_reg_dma_ops *dma_ops;
+	struct sde_reg_dma_buffer *feature_buf = dspp_buf[feature][idx];
+	struct reg_dma_dspp_batch *batch = &dspp_batch[ctl->idx];
+
+	if (batch->active) {
+		_reg_dma_dspp_batch_rollback(batch);
+		if (batch->buf->buffer_size - batch->index >=
+				feature_buf->buffer_size)
+			return batch->buf;
+	}
+
+	dma_ops = sde_reg_dma_get_ops();
+	dma_ops->reset_reg_dma_buf(feature_buf);
+
+	return feature_buf;
+}
+
+/**
+ * _reg_dma_dspp_kick_off - kick off a programmed dspp feature
+ * @ctl: ctl the feature is kicked off on
+ * @dma_buf: buffer returned by _reg_dma_dspp_get_buf
+ *
+ * Batched features are only marked complete, the batch is kicked off once
+ * from reg_dmav1_dspp_batch_end.
+ */
+static int _reg_dma_dspp_kick_off(struct sde_hw_ctl *ctl,
+		struct sde_reg_dma_buffer *dma_buf)
+{
+	struct sde_hw_reg_dma_ops *dma_ops;
+	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct reg_dma_dspp_batch *batch = &dspp_batch[ctl->idx];
+
+	if (batch->active && dma_buf == batch->buf) {
+		_reg_dma_dspp_batch_mark(batch);
+		return 0;
+	}
+
+	dma_ops = sde_reg_dma_get_ops();
+	REG_DMA_SETUP_KICKOFF(kick_off, ctl, dma_buf,
+			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
+
+	return dma_ops->kick_off(&kick_off);
+}
+
+/*
+ * DSPP features only program through reg dma when a feature buffer was set up
+ * by reg_dmav1_init_dspp_op_v4, i.e. when the hw reports reg dma support.
+ */
+static bool _reg_dma_dspp_supported(void)
+{
+	u32 i, j;
+
+	for (i = 0; i < REG_DMA_FEATURES_MAX; i++)
+		for (j = 0; j < DSPP_MAX; j++)
+			if (dspp_buf[i][j])
+				return true;
+
+	return false;
+}
+
+int reg_dmav1_dspp_batch_begin(struct sde_hw_ctl *ctl)
+{
+	struct sde_hw_reg_dma_ops *dma_ops;
+	struct reg_dma_dspp_batch *batch;
+	int rc;
+
+	if (!ctl || ctl->idx >= CTL_MAX)
+		return -EINVAL;
+
+	dma_ops = sde_reg_dma_get_ops();
+	if (IS_ERR_OR_NULL(dma_ops) || !dma_ops->reset_reg_dma_buf ||
+			!_reg_dma_dspp_supported())
+		return -ENOTSUPP;
+
+	batch = &dspp_batch[ctl->idx];
+	rc = reg_dma_buf_init(&batch->buf, REG_DMA_DSPP_BATCH_MEM_SIZE);
+	if (rc)
+		return rc;
+
+	dma_ops->reset_reg_dma_buf(batch->buf);
+	_reg_dma_dspp_batch_mark(batch);
+	batch->active = true;
+
+	return 0;
+}
+
+int reg_dmav1_dspp_batch_end(struct sde_hw_ctl *ctl)
+{
+	struct reg_dma_dspp_batch *batch;
+	int rc;
+
+	if (!ctl || ctl->idx >= CTL_MAX)
+		return -EINVAL;
+
+	batch = &dspp_batch[ctl->idx];
+	if (!batch->active)
+		return 0;
+
+	rc = _reg_dma_dspp_batch_flush(ctl, batch);
+	batch->active = false;
+
+	return rc;
+}
+
 int reg_dmav1_init_dspp_op_v4(int feature, enum sde_dspp idx)
 {
 	int rc = -ENOTSUPP;
@@ -300,7 +479,7 @@ void reg_dmav1_setup_dspp_vlutv18(struct sde_hw_dspp *ctx, void *cfg)
 	struct drm_msm_pa_vlut *payload = NULL;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_reg_dma_ops *dma_ops;
 	struct sde_hw_ctl *ctl = NULL;
 	u32 *data = NULL;
@@ -325,10 +504,10 @@ void reg_dmav1_setup_dspp_vlutv18(struct sde_hw_dspp *ctx, void *cfg)
 	}
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[VLUT][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, VLUT, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx],
-	VLUT, dspp_buf[VLUT][ctx->idx]);
+	VLUT, dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -375,9 +554,7 @@ void reg_dmav1_setup_dspp_vlutv18(struct sde_hw_dspp *ctx, void *cfg)
 		goto exit;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[VLUT][ctx->idx],
-	    REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc) {
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 		goto exit;
@@ -451,7 +628,7 @@ static int sde_gamut_get_mode_info(u32 pipe, struct drm_msm_3d_gamut *payload,
 
 static void dspp_3d_gamutv4_off(struct sde_hw_dspp *ctx, void *cfg)
 {
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	u32 op_mode = 0;
 	struct sde_hw_reg_dma_ops *dma_ops;
@@ -459,10 +636,10 @@ static void dspp_3d_gamutv4_off(struct sde_hw_dspp *ctx, void *cfg)
 	int rc;
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[GAMUT][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, GAMUT, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx], GAMUT,
-			dspp_buf[GAMUT][ctx->idx]);
+			dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -480,9 +657,7 @@ static void dspp_3d_gamutv4_off(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[GAMUT][ctx->idx],
-			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
@@ -491,7 +666,7 @@ static void reg_dmav1_setup_dspp_3d_gamutv4_common(struct sde_hw_dspp *ctx,
 		void *cfg, u32 scale_tbl_a_len, u32 scale_tbl_b_len)
 {
 	struct drm_msm_3d_gamut *payload;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	u32 op_mode, reg, tbl_len, tbl_off, scale_off, i;
 	u32 scale_tbl_len, scale_tbl_off;
@@ -525,10 +700,10 @@ static void reg_dmav1_setup_dspp_3d_gamutv4_common(struct sde_hw_dspp *ctx,
 	}
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[GAMUT][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, GAMUT, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx], GAMUT,
-			dspp_buf[GAMUT][ctx->idx]);
+			dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -589,9 +764,7 @@ static void reg_dmav1_setup_dspp_3d_gamutv4_common(struct sde_hw_dspp *ctx,
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[GAMUT][ctx->idx],
-			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
@@ -652,7 +825,7 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 {
 	struct drm_msm_pgc_lut *lut_cfg;
 	struct sde_hw_reg_dma_ops *dma_ops;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	int rc, i = 0;
@@ -676,10 +849,10 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 	lut_cfg = hw_cfg->payload;
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[GC][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, GC, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx], GC,
-			dspp_buf[GC][ctx->idx]);
+			dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -733,9 +906,7 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[GC][ctx->idx],
-			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc) {
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 		return;
@@ -744,7 +915,7 @@ void reg_dmav1_setup_dspp_gcv18(struct sde_hw_dspp *ctx, void *cfg)
 
 static void _dspp_igcv31_off(struct sde_hw_dspp *ctx, void *cfg)
 {
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_hw_reg_dma_ops *dma_ops;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
@@ -752,10 +923,10 @@ static void _dspp_igcv31_off(struct sde_hw_dspp *ctx, void *cfg)
 	u32 reg;
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[IGC][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, IGC, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx], IGC,
-		dspp_buf[IGC][ctx->idx]);
+		dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -774,9 +945,7 @@ static void _dspp_igcv31_off(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[IGC][ctx->idx],
-			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
@@ -785,7 +954,7 @@ void reg_dmav1_setup_dspp_igcv31(struct sde_hw_dspp *ctx, void *cfg)
 {
 	struct drm_msm_igc_lut *lut_cfg;
 	struct sde_hw_reg_dma_ops *dma_ops;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	int rc, i = 0, j = 0;
@@ -812,9 +981,9 @@ void reg_dmav1_setup_dspp_igcv31(struct sde_hw_dspp *ctx, void *cfg)
 	lut_cfg = hw_cfg->payload;
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[IGC][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, IGC, ctx->idx);
 
-	REG_DMA_INIT_OPS(dma_write_cfg, DSPP_IGC, IGC, dspp_buf[IGC][ctx->idx]);
+	REG_DMA_INIT_OPS(dma_write_cfg, DSPP_IGC, IGC, dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -845,7 +1014,7 @@ void reg_dmav1_setup_dspp_igcv31(struct sde_hw_dspp *ctx, void *cfg)
 	}
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx], IGC,
-		dspp_buf[IGC][ctx->idx]);
+		dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -876,16 +1045,14 @@ void reg_dmav1_setup_dspp_igcv31(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[IGC][ctx->idx],
-			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
 
 static void _dspp_pccv4_off(struct sde_hw_dspp *ctx, void *cfg)
 {
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_hw_reg_dma_ops *dma_ops;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
@@ -893,10 +1060,10 @@ static void _dspp_pccv4_off(struct sde_hw_dspp *ctx, void *cfg)
 	u32 reg;
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[PCC][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, PCC, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx], PCC,
-		dspp_buf[PCC][ctx->idx]);
+		dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -915,9 +1082,7 @@ static void _dspp_pccv4_off(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[PCC][ctx->idx],
-			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
@@ -925,7 +1090,7 @@ static void _dspp_pccv4_off(struct sde_hw_dspp *ctx, void *cfg)
 void reg_dmav1_setup_dspp_pccv4(struct sde_hw_dspp *ctx, void *cfg)
 {
 	struct sde_hw_reg_dma_ops *dma_ops;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	struct drm_msm_pcc *pcc_cfg;
@@ -953,10 +1118,10 @@ void reg_dmav1_setup_dspp_pccv4(struct sde_hw_dspp *ctx, void *cfg)
 	pcc_cfg = hw_cfg->payload;
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[PCC][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, PCC, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx],
-		PCC, dspp_buf[PCC][ctx->idx]);
+		PCC, dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -1024,9 +1189,7 @@ void reg_dmav1_setup_dspp_pccv4(struct sde_hw_dspp *ctx, void *cfg)
 		goto exit;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[PCC][ctx->idx],
-			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 
@@ -1037,7 +1200,7 @@ exit:
 void reg_dmav1_setup_dspp_pa_hsicv17(struct sde_hw_dspp *ctx, void *cfg)
 {
 	struct sde_hw_reg_dma_ops *dma_ops;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	struct drm_msm_pa_hsic *hsic_cfg;
@@ -1068,10 +1231,10 @@ void reg_dmav1_setup_dspp_pa_hsicv17(struct sde_hw_dspp *ctx, void *cfg)
 	hsic_cfg = hw_cfg->payload;
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[HSIC][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, HSIC, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx],
-		HSIC, dspp_buf[HSIC][ctx->idx]);
+		HSIC, dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -1148,9 +1311,7 @@ void reg_dmav1_setup_dspp_pa_hsicv17(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[HSIC][ctx->idx],
-			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
@@ -1158,7 +1319,7 @@ void reg_dmav1_setup_dspp_pa_hsicv17(struct sde_hw_dspp *ctx, void *cfg)
 void reg_dmav1_setup_dspp_sixzonev17(struct sde_hw_dspp *ctx, void *cfg)
 {
 	struct sde_hw_reg_dma_ops *dma_ops;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	struct drm_msm_sixzone *sixzone;
@@ -1191,10 +1352,10 @@ void reg_dmav1_setup_dspp_sixzonev17(struct sde_hw_dspp *ctx, void *cfg)
 	sixzone = hw_cfg->payload;
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[SIX_ZONE][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, SIX_ZONE, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx],
-		SIX_ZONE, dspp_buf[SIX_ZONE][ctx->idx]);
+		SIX_ZONE, dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -1267,10 +1428,7 @@ void reg_dmav1_setup_dspp_sixzonev17(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl,
-		dspp_buf[SIX_ZONE][ctx->idx],
-		REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
@@ -1295,6 +1453,14 @@ int reg_dmav1_deinit_dspp_ops(enum sde_dspp idx)
 		dma_ops->dealloc_reg_dma(dspp_buf[i][idx]);
 		dspp_buf[i][idx] = NULL;
 	}
+
+	/* batch buffers are re-allocated on the next batch begin */
+	for (i = 0; i < CTL_MAX; i++) {
+		if (!dspp_batch[i].buf || dspp_batch[i].active)
+			continue;
+		dma_ops->dealloc_reg_dma(dspp_batch[i].buf);
+		dspp_batch[i].buf = NULL;
+	}
 	return 0;
 }
 
@@ -1304,7 +1470,7 @@ static void __setup_dspp_memcol(struct sde_hw_dspp *ctx,
 {
 	struct sde_hw_reg_dma_ops *dma_ops;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct drm_msm_memcol *memcolor;
 	int rc;
 	u32 addr = 0, idx = 0;
@@ -1330,10 +1496,10 @@ static void __setup_dspp_memcol(struct sde_hw_dspp *ctx,
 	}
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[type][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, type, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx],
-		type, dspp_buf[type][ctx->idx]);
+		type, dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -1400,10 +1566,7 @@ static void __setup_dspp_memcol(struct sde_hw_dspp *ctx,
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl,
-		dspp_buf[type][ctx->idx],
-		REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
@@ -1518,7 +1681,7 @@ void reg_dmav1_setup_dspp_memcol_protv17(struct sde_hw_dspp *ctx, void *cfg)
 	struct sde_hw_cp_cfg *hw_cfg = cfg;
 	struct sde_hw_reg_dma_ops *dma_ops;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
-	struct sde_reg_dma_kickoff_cfg kick_off;
+	struct sde_reg_dma_buffer *dma_buf;
 	struct drm_msm_memcol *memcolor;
 	int rc;
 	u32 opcode = 0, opcode_mask = 0xFFFFFFFF;
@@ -1574,10 +1737,10 @@ void reg_dmav1_setup_dspp_memcol_protv17(struct sde_hw_dspp *ctx, void *cfg)
 	opcode_mask &= ~(MEMCOL_PROT_MASK);
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[MEMC_PROT][ctx->idx]);
+	dma_buf = _reg_dma_dspp_get_buf(hw_cfg->ctl, MEMC_PROT, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, dspp_mapping[ctx->idx],
-		MEMC_PROT, dspp_buf[MEMC_PROT][ctx->idx]);
+		MEMC_PROT, dma_buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -1595,10 +1758,7 @@ void reg_dmav1_setup_dspp_memcol_protv17(struct sde_hw_dspp *ctx, void *cfg)
 		return;
 	}
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl,
-			dspp_buf[MEMC_PROT][ctx->idx], REG_DMA_WRITE,
-			DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
-	rc = dma_ops->kick_off(&kick_off);
+	rc = _reg_dma_dspp_kick_off(hw_cfg->ctl, dma_buf);
 	if (rc)
 		DRM_ERROR("failed to kick off ret %d\n", rc);
 }
@@ -10,6 +10,8 @@
 #include "sde_hw_dspp.h"
 #include "sde_hw_sspp.h"
 
+struct sde_hw_ctl;
+
 /**
  * reg_dmav1_init_dspp_op_v4() - initialize the dspp feature op for sde v4
  *                               using reg dma v1.
@@ -18,6 +20,20 @@
  */
 int reg_dmav1_init_dspp_op_v4(int feature, enum sde_dspp idx);
 
+/**
+ * reg_dmav1_dspp_batch_begin() - start batching dspp features of a ctl into
+ *                                a single reg dma kick off.
+ * @ctl: ctl the dspp features are kicked off on
+ */
+int reg_dmav1_dspp_batch_begin(struct sde_hw_ctl *ctl);
+
+/**
+ * reg_dmav1_dspp_batch_end() - kick off all dspp features batched since
+ *                              reg_dmav1_dspp_batch_begin() and stop batching.
+ * @ctl: ctl the dspp features are kicked off on
+ */
+int reg_dmav1_dspp_batch_end(struct sde_hw_ctl *ctl);
+
 /**
  * reg_dmav1_setup_dspp_vlutv18() - vlut v18 implementation using reg dma v1.
  * @ctx: dspp ctx info
@@ -100,6 +100,29 @@
 #define SSPP_VIG_CSC_10_OP_MODE            0x0
 #define SSPP_TRAFFIC_SHAPER_BPC_MAX        0xFF
 
+/*
+ * Plain configuration registers of the source block cached by reg shadow,
+ * relative to the source sub-block. Address, status and write-to-clear
+ * registers such as SSPP_UBWC_ERROR_STATUS are deliberately left out.
+ */
+static const struct sde_hw_reg_range sspp_shadow_regs[] = {
+	{SSPP_SRC_SIZE, SSPP_SRC0_ADDR - SSPP_SRC_SIZE},
+	{SSPP_SRC_YSTRIDE0, 0x8},
+	{SSPP_SRC_FORMAT, 0x10},
+	{SSPP_UBWC_STATIC_CTRL, 0x8},
+	{SSPP_DANGER_LUT, 0x10},
+	{SSPP_CREQ_LUT_0, 0x8},
+	{SSPP_DECIMATION_CONFIG, 0x4},
+	{SSPP_CDP_CNTL, 0x4},
+	{SSPP_CDP_CNTL_REC1, 0x4},
+	{SSPP_OUT_SIZE_REC1, SSPP_EXCL_REC_SIZE_REC1 - SSPP_OUT_SIZE_REC1},
+};
+
+/* CSC matrix, clamp and bias registers, relative to the csc sub-block */
+static const struct sde_hw_reg_range sspp_csc_shadow_regs[] = {
+	{0x0, 0x44},
+};
+
 /* SSPP_QOS_CTRL */
 #define SSPP_QOS_CTRL_VBLANK_EN            BIT(16)
 #define SSPP_QOS_CTRL_DANGER_SAFE_EN       BIT(0)
@@ -1347,6 +1370,27 @@ struct sde_hw_pipe *sde_hw_sspp_init(enum sde_sspp idx,
 		goto blk_init_error;
 	}
 
+	/* virtual pipes share the shadow of their master, see sde_plane */
+	if (!is_virtual_pipe) {
+		if (sde_hw_reg_shadow_init(&hw_pipe->hw))
+			SDE_ERROR("failed to init reg shadow for sspp %d\n",
+					idx);
+
+		sde_hw_reg_shadow_allow(&hw_pipe->hw, cfg->sblk->src_blk.base,
+				sspp_shadow_regs, ARRAY_SIZE(sspp_shadow_regs));
+		if (test_bit(SDE_SSPP_CSC, &cfg->features))
+			sde_hw_reg_shadow_allow(&hw_pipe->hw,
+					cfg->sblk->csc_blk.base,
+					sspp_csc_shadow_regs,
+					ARRAY_SIZE(sspp_csc_shadow_regs));
+		else if (test_bit(SDE_SSPP_CSC_10BIT, &cfg->features))
+			sde_hw_reg_shadow_allow(&hw_pipe->hw,
+					cfg->sblk->csc_blk.base +
+					CSC_10BIT_OFFSET,
+					sspp_csc_shadow_regs,
+					ARRAY_SIZE(sspp_csc_shadow_regs));
+	}
+
 	if (!is_virtual_pipe)
 		sde_dbg_reg_register_dump_range(SDE_DBG_NAME, cfg->name,
 			hw_pipe->hw.blk_off,
@@ -1372,6 +1416,7 @@ blk_init_error:
 void sde_hw_sspp_destroy(struct sde_hw_pipe *ctx)
 {
 	if (ctx) {
+		sde_hw_reg_shadow_destroy(&ctx->hw);
 		sde_hw_blk_destroy(&ctx->base);
 		kfree(ctx->cap);
 	}
@@ -4,6 +4,10 @@
  */
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
 
+#include <linux/hash.h>
+#include <linux/kref.h>
+#include <linux/log2.h>
+#include <linux/seq_file.h>
 #include <uapi/drm/sde_drm.h>
 #include "msm_drv.h"
 #include "sde_kms.h"
@@ -13,6 +17,156 @@
 /* using a file static variables for debugfs access */
 static u32 sde_hw_util_log_mask = SDE_DBG_MASK_NONE;
 
+/*
+ * reg_shadow - skip register writes of blocks that opted in through
+ *	sde_hw_reg_shadow_init when the register already holds the value.
+ *	This is disabled by default.
+ */
+static bool reg_shadow;
+module_param(reg_shadow, bool, 0400);
+MODULE_PARM_DESC(reg_shadow, "Skip redundant register writes of sde blocks");
+
+/**
+ * struct sde_hw_reg_shadow_ent - shadow of one 32-bit register
+ * @val: last value written to the register
+ * @gen: generation @val was written in, stale unless it matches the current
+ */
+struct sde_hw_reg_shadow_ent {
+	u32 val;
+	u32 gen;
+};
+
+/**
+ * struct sde_hw_reg_shadow - last values written to a register block
+ * @list: node in the list of all shadows, for statistics
+ * @kref: reference count, shadows may be shared by several register maps
+ * @blk_off: offset of the block, to identify it in statistics
+ * @count: number of registers covered, from the block length
+ * @gen: per block generation, bumped to invalidate all entries at once
+ * @ent: shadow entries, one per register
+ * @cache: bitmap of registers whose writes may be skipped
+ * @written: number of writes issued to hardware
+ * @skipped: number of writes skipped as unchanged
+ */
+struct sde_hw_reg_shadow {
+	struct list_head list;
+	struct kref kref;
+	u32 blk_off;
+	u32 count;
+	u32 gen;
+	struct sde_hw_reg_shadow_ent *ent;
+	unsigned long *cache;
+	u64 written;
+	u64 skipped;
+};
+
+/* generation shared by all shadows, bumped on power collapse */
+static u32 sde_hw_reg_shadow_gen = 1;
+static LIST_HEAD(sde_hw_reg_shadow_list);
+static DEFINE_MUTEX(sde_hw_reg_shadow_lock);
+
+/**
+ * _sde_hw_reg_shadow_update - check a register write against the shadow
+ * @s: register shadow of the block
+ * @reg_off: register offset within the block
+ * @val: value to be written
+ * @Return: true if the write needs to reach hardware
+ */
+static inline bool _sde_hw_reg_shadow_update(struct sde_hw_reg_shadow *s,
+		u32 reg_off, u32 val)
+{
+	struct sde_hw_reg_shadow_ent *ent;
+	u32 idx = reg_off >> 2;
+	u32 gen;
+
+	if ((reg_off & 0x3) || idx >= s->count || !test_bit(idx, s->cache)) {
+		s->written++;
+		return true;
+	}
+
+	/* both generations only grow, so their sum changes on either bump */
+	gen = READ_ONCE(s->gen) + READ_ONCE(sde_hw_reg_shadow_gen);
+	ent = &s->ent[idx];
+	if (ent->gen == gen && ent->val == val) {
+		s->skipped++;
+		return false;
+	}
+
+	ent->val = val;
+	ent->gen = gen;
+	s->written++;
+
+	return true;
+}
+
+/**
+ * _sde_hw_reg_rec_head - latest write recorded in a hash bucket
+ * @rec: register record
+ * @h: hash bucket
+ * @Return: index of the write, or @rec->max if the bucket is empty
+ *
+ * Buckets are not cleared when the record is written out; an index left
+ * from an earlier frame is told apart by checking it against the count
+ * and the bucket of the offset now stored at that index.
+ */
+static inline u32 _sde_hw_reg_rec_head(struct sde_hw_reg_rec *rec, u32 h)
+{
+	u32 i = rec->head[h];
+
+	if (i >= rec->count || hash_32(rec->off[i] >> 2, rec->hash_bits) != h)
+		return rec->max;
+
+	return i;
+}
+
+/**
+ * _sde_hw_reg_rec_write - hold back a register write in a record
+ * @rec: register record
+ * @off: register offset relative to the mdp base
+ * @val: value to be written
+ */
+static inline void _sde_hw_reg_rec_write(struct sde_hw_reg_rec *rec,
+		u32 off, u32 val)
+{
+	u32 h;
+
+	/* a full record is written out early, keeping the write order */
+	if (rec->count == rec->max)
+		sde_hw_reg_rec_replay(rec);
+
+	h = hash_32(off >> 2, rec->hash_bits);
+	rec->prev[rec->count] = _sde_hw_reg_rec_head(rec, h);
+	rec->head[h] = rec->count;
+
+	rec->off[rec->count] = off;
+	rec->val[rec->count] = val;
+	rec->count++;
+}
+
+/**
+ * _sde_hw_reg_rec_read - look up the last value recorded for a register
+ * @rec: register record
+ * @off: register offset relative to the mdp base
+ * @val: output, recorded value
+ * @Return: true if the register has a write held back in the record
+ */
+static bool _sde_hw_reg_rec_read(struct sde_hw_reg_rec *rec, u32 off,
+		u32 *val)
+{
+	u32 i;
+
+	/* walk only the writes hashed to the same bucket, newest first */
+	i = _sde_hw_reg_rec_head(rec, hash_32(off >> 2, rec->hash_bits));
+	for (; i < rec->max; i = rec->prev[i]) {
+		if (rec->off[i] == off) {
+			*val = rec->val[i];
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /* SDE_SCALER_QSEED3 */
 #define QSEED3_HW_VERSION                  0x00
 #define QSEED3_OP_MODE                     0x04
@@ -72,15 +226,31 @@ void sde_reg_write(struct sde_hw_blk_reg_map *c,
 		u32 val,
 		const char *name)
 {
+	if (c->shadow && !_sde_hw_reg_shadow_update(c->shadow, reg_off, val))
+		return;
+
 	/* don't need to mutex protect this */
 	if (c->log_mask & sde_hw_util_log_mask)
 		SDE_DEBUG_DRIVER("[%s:0x%X] <= 0x%X\n",
 				name, c->blk_off + reg_off, val);
+
+	if (c->rec && c->rec->active) {
+		_sde_hw_reg_rec_write(c->rec, c->blk_off + reg_off, val);
+		return;
+	}
+
 	writel_relaxed(val, c->base_off + c->blk_off + reg_off);
 }
 
 int sde_reg_read(struct sde_hw_blk_reg_map *c, u32 reg_off)
 {
+	u32 val;
+
+	/* read-modify-write sequences must see the writes held back */
+	if (c->rec && c->rec->active &&
+			_sde_hw_reg_rec_read(c->rec, c->blk_off + reg_off, &val))
+		return val;
+
 	return readl_relaxed(c->base_off + c->blk_off + reg_off);
 }
 
@@ -89,6 +259,182 @@ u32 *sde_hw_util_get_log_mask_ptr(void)
 	return &sde_hw_util_log_mask;
 }
 
+int sde_hw_reg_shadow_init(struct sde_hw_blk_reg_map *c)
+{
+	struct sde_hw_reg_shadow *s;
+
+	if (!c || !reg_shadow || c->shadow)
+		return 0;
+
+	s = kzalloc(sizeof(*s), GFP_KERNEL);
+	if (!s)
+		return -ENOMEM;
+
+	s->count = DIV_ROUND_UP(c->length, sizeof(u32));
+	s->ent = kcalloc(s->count, sizeof(*s->ent), GFP_KERNEL);
+	s->cache = kcalloc(BITS_TO_LONGS(s->count), sizeof(unsigned long),
+			GFP_KERNEL);
+	if (!s->ent || !s->cache) {
+		kfree(s->ent);
+		kfree(s->cache);
+		kfree(s);
+		return -ENOMEM;
+	}
+
+	kref_init(&s->kref);
+	s->blk_off = c->blk_off;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	list_add_tail(&s->list, &sde_hw_reg_shadow_list);
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+
+	c->shadow = s;
+
+	return 0;
+}
+
+void sde_hw_reg_shadow_allow(struct sde_hw_blk_reg_map *c, u32 base,
+		const struct sde_hw_reg_range *ranges, u32 cnt)
+{
+	struct sde_hw_reg_shadow *s;
+	u32 i, idx, end;
+
+	if (!c || !c->shadow || !ranges)
+		return;
+
+	s = c->shadow;
+	for (i = 0; i < cnt; i++) {
+		idx = (base + ranges[i].off) >> 2;
+		end = min((base + ranges[i].off + ranges[i].len) >> 2,
+				s->count);
+		for (; idx < end; idx++)
+			set_bit(idx, s->cache);
+	}
+}
+
+void sde_hw_reg_shadow_share(struct sde_hw_blk_reg_map *c,
+		struct sde_hw_blk_reg_map *src)
+{
+	if (!c || !src || !src->shadow || c->shadow)
+		return;
+
+	kref_get(&src->shadow->kref);
+	c->shadow = src->shadow;
+}
+
+static void _sde_hw_reg_shadow_release(struct kref *kref)
+{
+	struct sde_hw_reg_shadow *s =
+			container_of(kref, struct sde_hw_reg_shadow, kref);
+
+	list_del(&s->list);
+	kfree(s->ent);
+	kfree(s->cache);
+	kfree(s);
+}
+
+void sde_hw_reg_shadow_destroy(struct sde_hw_blk_reg_map *c)
+{
+	if (!c || !c->shadow)
+		return;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	kref_put(&c->shadow->kref, _sde_hw_reg_shadow_release);
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+
+	c->shadow = NULL;
+}
+
+void sde_hw_reg_shadow_invalidate(struct sde_hw_blk_reg_map *c)
+{
+	if (c && c->shadow)
+		WRITE_ONCE(c->shadow->gen, c->shadow->gen + 1);
+}
+
+void sde_hw_reg_shadow_invalidate_all(void)
+{
+	WRITE_ONCE(sde_hw_reg_shadow_gen, sde_hw_reg_shadow_gen + 1);
+}
+
+int sde_hw_reg_shadow_stats(struct seq_file *s)
+{
+	struct sde_hw_reg_shadow *shadow;
+	u64 written = 0, skipped = 0;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	list_for_each_entry(shadow, &sde_hw_reg_shadow_list, list) {
+		seq_printf(s, "blk 0x%08x: written %llu skipped %llu\n",
+				shadow->blk_off, shadow->written,
+				shadow->skipped);
+		written += shadow->written;
+		skipped += shadow->skipped;
+	}
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+
+	seq_printf(s, "total: written %llu skipped %llu\n", written, skipped);
+
+	return 0;
+}
+
+struct sde_hw_reg_rec *sde_hw_reg_rec_create(void __iomem *base_off, u32 max)
+{
+	struct sde_hw_reg_rec *rec;
+
+	if (!base_off || !max)
+		return NULL;
+
+	rec = kzalloc(sizeof(*rec), GFP_KERNEL);
+	if (!rec)
+		return NULL;
+
+	/* twice as many buckets as writes keeps the chains short */
+	rec->hash_bits = ilog2(roundup_pow_of_two(max)) + 1;
+
+	rec->off = kcalloc(max, sizeof(*rec->off), GFP_KERNEL);
+	rec->val = kcalloc(max, sizeof(*rec->val), GFP_KERNEL);
+	rec->prev = kcalloc(max, sizeof(*rec->prev), GFP_KERNEL);
+	rec->head = kcalloc(1 << rec->hash_bits, sizeof(*rec->head),
+			GFP_KERNEL);
+	if (!rec->off || !rec->val || !rec->prev || !rec->head) {
+		kfree(rec->off);
+		kfree(rec->val);
+		kfree(rec->prev);
+		kfree(rec->head);
+		kfree(rec);
+		return NULL;
+	}
+
+	rec->max = max;
+	rec->base_off = base_off;
+
+	return rec;
+}
+
+void sde_hw_reg_rec_destroy(struct sde_hw_reg_rec *rec)
+{
+	if (!rec)
+		return;
+
+	kfree(rec->off);
+	kfree(rec->val);
+	kfree(rec->prev);
+	kfree(rec->head);
+	kfree(rec);
+}
+
+void sde_hw_reg_rec_replay(struct sde_hw_reg_rec *rec)
+{
+	u32 i;
+
+	if (!rec)
+		return;
+
+	for (i = 0; i < rec->count; i++)
+		writel_relaxed(rec->val[i], rec->base_off + rec->off[i]);
+
+	rec->count = 0;
+}
+
 void sde_init_scaler_blk(struct sde_scaler_blk *blk, u32 version)
 {
 	if (!blk)
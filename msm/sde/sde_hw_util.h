@@ -13,6 +13,9 @@
 
 #define REG_MASK(n)                     ((BIT(n)) - 1)
 struct sde_format_extended;
+struct sde_hw_reg_shadow;
+struct sde_hw_reg_rec;
+struct seq_file;
 
 /*
  * This is the common struct maintained by each sub block
@@ -23,6 +26,9 @@ struct sde_format_extended;
  * @length        length of register block offset
  * @xin_id        xin id
  * @hwversion     mdss hw version number
+ * @shadow        cache of last written values, NULL if not enabled
+ * @rec           register record writes are diverted to while it is active,
+ *                NULL to always write to hardware
  */
 struct sde_hw_blk_reg_map {
 	void __iomem *base_off;
@@ -31,6 +37,32 @@ struct sde_hw_blk_reg_map {
 	u32 xin_id;
 	u32 hwversion;
 	u32 log_mask;
+	struct sde_hw_reg_shadow *shadow;
+	struct sde_hw_reg_rec *rec;
+};
+
+/**
+ * struct sde_hw_reg_rec - register writes held back to be issued together
+ * @off: register offsets relative to the mdp base, in recording order
+ * @val: values to be written, parallel to @off
+ * @count: number of recorded writes
+ * @max: capacity of @off and @val
+ * @head: per offset hash bucket, index of the latest write in the bucket
+ * @prev: per write, index of the previous write in the same bucket
+ * @hash_bits: log2 of the number of @head buckets
+ * @base_off: mdp register mapped offset, to write the record over ahb
+ * @active: writes of register maps attached to the record are held back
+ */
+struct sde_hw_reg_rec {
+	u32 *off;
+	u32 *val;
+	u32 count;
+	u32 max;
+	u32 *head;
+	u32 *prev;
+	u32 hash_bits;
+	void __iomem *base_off;
+	bool active;
 };
 
 /**
@@ -169,6 +201,93 @@ int sde_reg_read(struct sde_hw_blk_reg_map *c, u32 reg_off);
 #define SDE_REG_WRITE(c, off, val) sde_reg_write(c, off, val, #off)
 #define SDE_REG_READ(c, off) sde_reg_read(c, off)
 
+/**
+ * struct sde_hw_reg_range - range of registers within a block
+ * @off: offset of the first register, relative to the block
+ * @len: length of the range in bytes
+ */
+struct sde_hw_reg_range {
+	u32 off;
+	u32 len;
+};
+
+/**
+ * sde_hw_reg_shadow_init - enable the register shadow cache of a block.
+ *	Only registers later passed to sde_hw_reg_shadow_allow are cached.
+ *	No-op unless the reg_shadow module parameter is set.
+ * @c: register map of the block, length must be set
+ * @Return: 0 on success or -ENOMEM
+ */
+int sde_hw_reg_shadow_init(struct sde_hw_blk_reg_map *c);
+
+/**
+ * sde_hw_reg_shadow_allow - mark plain configuration registers as cacheable,
+ *	so that writes of the value they already hold are skipped. Trigger,
+ *	status and self-clearing registers must never be listed.
+ * @c: register map of the block
+ * @base: offset added to each range, e.g. a sub-block base
+ * @ranges: register ranges relative to @base
+ * @cnt: number of entries in @ranges
+ */
+void sde_hw_reg_shadow_allow(struct sde_hw_blk_reg_map *c, u32 base,
+		const struct sde_hw_reg_range *ranges, u32 cnt);
+
+/**
+ * sde_hw_reg_shadow_share - use the shadow of another register map which
+ *	maps the same registers, e.g. for virtual pipes
+ * @c: register map to attach the shadow to
+ * @src: register map owning the shadow
+ */
+void sde_hw_reg_shadow_share(struct sde_hw_blk_reg_map *c,
+		struct sde_hw_blk_reg_map *src);
+
+/**
+ * sde_hw_reg_shadow_destroy - drop the shadow reference of a register map
+ * @c: register map
+ */
+void sde_hw_reg_shadow_destroy(struct sde_hw_blk_reg_map *c);
+
+/**
+ * sde_hw_reg_shadow_invalidate - forget the cached values of a block, needed
+ *	after its registers are reset or written behind the cpu's back
+ * @c: register map
+ */
+void sde_hw_reg_shadow_invalidate(struct sde_hw_blk_reg_map *c);
+
+/**
+ * sde_hw_reg_shadow_invalidate_all - forget the cached values of all blocks,
+ *	needed when the hardware loses its register state on power collapse
+ */
+void sde_hw_reg_shadow_invalidate_all(void);
+
+/**
+ * sde_hw_reg_shadow_stats - print written/skipped counts of all shadows
+ * @s: seq file to print to
+ * @Return: 0 on success
+ */
+int sde_hw_reg_shadow_stats(struct seq_file *s);
+
+/**
+ * sde_hw_reg_rec_create - allocate a register record
+ * @base_off: mdp register mapped offset
+ * @max: number of writes the record holds before it is written out over ahb
+ * @Return: record on success or NULL
+ */
+struct sde_hw_reg_rec *sde_hw_reg_rec_create(void __iomem *base_off, u32 max);
+
+/**
+ * sde_hw_reg_rec_destroy - free a register record
+ * @rec: register record
+ */
+void sde_hw_reg_rec_destroy(struct sde_hw_reg_rec *rec);
+
+/**
+ * sde_hw_reg_rec_replay - write the recorded values over ahb in recording
+ *	order and empty the record, used when they can't be sent by reg dma
+ * @rec: register record
+ */
+void sde_hw_reg_rec_replay(struct sde_hw_reg_rec *rec);
+
 #define MISR_FRAME_COUNT_MASK		0xFF
 #define MISR_CTRL_ENABLE		BIT(8)
 #define MISR_CTRL_STATUS		BIT(9)
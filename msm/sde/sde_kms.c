@@ -184,6 +184,12 @@ static int sde_debugfs_safe_stats_show(struct seq_file *s, void *v)
 }
 DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_debugfs_safe_stats);
 
+static int sde_debugfs_reg_shadow_stats_show(struct seq_file *s, void *v)
+{
+	return sde_hw_reg_shadow_stats(s);
+}
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_debugfs_reg_shadow_stats);
+
 static void sde_debugfs_danger_destroy(struct sde_kms *sde_kms)
 {
 	debugfs_remove_recursive(sde_kms->debugfs_danger);
@@ -326,10 +332,13 @@ static int _sde_debugfs_init(struct sde_kms *sde_kms)
 
 	/* allow debugfs_root to be NULL */
 	debugfs_create_x32(SDE_DEBUGFS_HWMASKNAME, 0600, debugfs_root, p);
+	debugfs_create_file("reg_shadow_stats", 0400, debugfs_root, sde_kms,
+			&sde_debugfs_reg_shadow_stats_fops);
 
 	(void) sde_debugfs_danger_init(sde_kms, debugfs_root);
 	(void) sde_debugfs_vbif_init(sde_kms, debugfs_root);
 	(void) sde_debugfs_core_irq_init(sde_kms, debugfs_root);
+	(void) sde_rm_debugfs_init(&sde_kms->rm, debugfs_root);
 
 	rc = sde_core_perf_debugfs_init(&sde_kms->perf, debugfs_root);
 	if (rc) {
@@ -3299,6 +3308,8 @@ static void sde_kms_handle_power_event(u32 event_type, void *usr)
 	SDE_EVT32_VERBOSE(event_type);
 
 	if (event_type == SDE_POWER_EVENT_POST_ENABLE) {
+		/* register contents are lost across power collapse */
+		sde_hw_reg_shadow_invalidate_all();
 		sde_irq_update(msm_kms, true);
 		sde_vbif_init_memtypes(sde_kms);
 		sde_kms_init_shared_hw(sde_kms);
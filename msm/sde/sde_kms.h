@@ -201,7 +201,8 @@ struct sde_irq_callback {
  * @total_irq:    total number of irq_idx obtained from HW interrupts mapping
  * @irq_cb_tbl:   array of IRQ callbacks setting
  * @enable_counts array of IRQ enable counts
- * @cb_lock:      callback lock
+ * @cb_active:    array of handlers currently walking each irq_cb_tbl list
+ * @cb_lock:      callback lock, serializes irq_cb_tbl writers only
  * @debugfs_file: debugfs file for irq statistics
  */
 struct sde_irq {
@@ -209,6 +210,7 @@ struct sde_irq {
 	struct list_head *irq_cb_tbl;
 	atomic_t *enable_counts;
 	atomic_t *irq_counts;
+	atomic_t *cb_active;
 	spinlock_t cb_lock;
 	struct dentry *debugfs_file;
 };
@@ -207,6 +207,26 @@ static struct sde_hw_ctl *_sde_plane_get_hw_ctl(const struct drm_plane *plane)
 	return ctl;
 }
 
+/**
+ * _sde_plane_reg_rec_attach - route the rect, format and address writes of
+ *	the pipe into the register record of the crtc's ctl, if it records
+ * @plane: Pointer to drm plane
+ * @attach: true to route the writes into the record, false to restore
+ */
+static void _sde_plane_reg_rec_attach(struct drm_plane *plane, bool attach)
+{
+	struct sde_plane *psde = to_sde_plane(plane);
+	struct sde_hw_ctl *ctl = NULL;
+
+	if (!psde->pipe_hw)
+		return;
+
+	if (attach)
+		ctl = _sde_plane_get_hw_ctl(plane);
+
+	psde->pipe_hw->hw.rec = ctl ? ctl->rec : NULL;
+}
+
 /**
  * _sde_plane_get_crtc_state - obtain crtc state attached to given plane state
  * @pstate: Pointer to drm plane state
@@ -3846,15 +3866,22 @@ void sde_plane_flush(struct drm_plane *plane)
 	/*
 	 * These updates have to be done immediately before the plane flush
 	 * timing, and may not be moved to the atomic_update/mode_set functions.
+	 * Color fill rewrites the rects and format, so it has to be ordered
+	 * with the writes already held back in the register record.
 	 */
-	if (psde->is_error)
-		/* force white frame with 100% alpha pipe output on error */
-		_sde_plane_color_fill(psde, 0xFFFFFF, 0xFF);
-	else if (psde->color_fill & SDE_PLANE_COLOR_FILL_FLAG)
-		/* force 100% alpha */
-		_sde_plane_color_fill(psde, psde->color_fill, 0xFF);
-	else if (psde->pipe_hw && psde->csc_ptr && psde->pipe_hw->ops.setup_csc)
+	if (psde->is_error || (psde->color_fill & SDE_PLANE_COLOR_FILL_FLAG)) {
+		_sde_plane_reg_rec_attach(plane, true);
+		if (psde->is_error)
+			/* force white frame with 100% alpha pipe output */
+			_sde_plane_color_fill(psde, 0xFFFFFF, 0xFF);
+		else
+			/* force 100% alpha */
+			_sde_plane_color_fill(psde, psde->color_fill, 0xFF);
+		_sde_plane_reg_rec_attach(plane, false);
+	} else if (psde->pipe_hw && psde->csc_ptr &&
+			psde->pipe_hw->ops.setup_csc) {
 		psde->pipe_hw->ops.setup_csc(psde->pipe_hw, psde->csc_ptr);
+	}
 
 	/* flag h/w flush complete */
 	if (plane->state)
@@ -4030,7 +4057,9 @@ static int sde_plane_sspp_atomic_update(struct drm_plane *plane,
 	if (pstate->dirty & SDE_PLANE_DIRTY_RECTS)
 		memset(&(psde->pipe_cfg), 0, sizeof(struct sde_hw_pipe_cfg));
 
+	_sde_plane_reg_rec_attach(plane, true);
 	_sde_plane_set_scanout(plane, pstate, &psde->pipe_cfg, fb);
+	_sde_plane_reg_rec_attach(plane, false);
 
 	/* early out if nothing dirty */
 	if (!pstate->dirty)
@@ -4103,9 +4132,11 @@ static int sde_plane_sspp_atomic_update(struct drm_plane *plane,
 			/* skip remaining processing on color fill */
 			pstate->dirty = 0x0;
 		} else if (psde->pipe_hw->ops.setup_rects) {
+			_sde_plane_reg_rec_attach(plane, true);
 			psde->pipe_hw->ops.setup_rects(psde->pipe_hw,
 					&psde->pipe_cfg,
 					pstate->multirect_index);
+			_sde_plane_reg_rec_attach(plane, false);
 		}
 
 		if (psde->pipe_hw->ops.setup_pe &&
@@ -4156,9 +4187,11 @@ static int sde_plane_sspp_atomic_update(struct drm_plane *plane,
 			src_flags |= SDE_SSPP_FLIP_UD;
 
 		/* update format */
+		_sde_plane_reg_rec_attach(plane, true);
 		psde->pipe_hw->ops.setup_format(psde->pipe_hw, fmt,
 				pstate->const_alpha_en, src_flags,
 				pstate->multirect_index);
+		_sde_plane_reg_rec_attach(plane, false);
 
 		if (psde->pipe_hw->ops.setup_cdp) {
 			struct sde_hw_pipe_cdp_cfg *cdp_cfg = &pstate->cdp_cfg;
@@ -5493,6 +5526,11 @@ struct drm_plane *sde_plane_init(struct drm_device *dev,
 		goto clean_sspp;
 	}
 
+	/* virtual pipes program the same registers as their master */
+	if (master_plane)
+		sde_hw_reg_shadow_share(&psde->pipe_hw->hw,
+				&to_sde_plane(master_plane)->pipe_hw->hw);
+
 	/* cache features mask for later */
 	psde->features = psde->pipe_hw->cap->features;
 	psde->pipe_sblk = psde->pipe_hw->cap->sblk;
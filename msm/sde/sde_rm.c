@@ -4,6 +4,7 @@
  */
 
 #define pr_fmt(fmt)	"[drm:%s] " fmt, __func__
+#include <linux/debugfs.h>
 #include "sde_kms.h"
 #include "sde_hw_lm.h"
 #include "sde_hw_ctl.h"
@@ -32,6 +33,10 @@
 				(t).num_comp_enc == (r).num_enc && \
 				(t).num_intf == (r).num_intf)
 
+/* bitmap index of blocks not created from the catalog, e.g. external blocks */
+#define RM_BLK_IDX_NONE	BITS_PER_LONG
+#define RM_BLK_IDX_VALID(b) ((b)->idx < RM_BLK_IDX_NONE)
+
 /**
  * toplogy information to be used when ctl path version does not
  * support driving more than one interface per ctl_path
@@ -93,12 +98,18 @@ struct sde_rm_requirements {
  *		CRTCs may be connected to multiple Encoders.
  *		An encoder or connector id identifies the display path.
  * @topology	DRM<->HW topology use case
+ * @blk_mask:	Per type bitmap of the catalog blocks committed to this
+ *		reservation, indexed by sde_rm_hw_blk idx
+ * @reqs:	Requirements this reservation was made for, as populated
+ *		before reservation, used to reuse it for identical requests
  */
 struct sde_rm_rsvp {
 	struct list_head list;
 	uint32_t seq;
 	uint32_t enc_id;
 	enum sde_rm_topology_name topology;
+	unsigned long blk_mask[SDE_HW_BLK_MAX];
+	struct sde_rm_requirements reqs;
 };
 
 /**
@@ -109,6 +120,8 @@ struct sde_rm_rsvp {
  *		request. Will be swapped into rsvp if proposal is accepted
  * @type:	Type of hardware block this structure tracks
  * @id:		Hardware ID number, within it's own space, ie. LM_X
+ * @idx:	Index of this block within its type for reservation bitmaps,
+ *		RM_BLK_IDX_NONE if the block is not tracked in bitmaps
  * @catalog:	Pointer to the hardware catalog entry for this block
  * @hw:		Pointer to the hardware register access object for this block
  */
@@ -118,9 +131,30 @@ struct sde_rm_hw_blk {
 	struct sde_rm_rsvp *rsvp_nxt;
 	enum sde_hw_blk_type type;
 	uint32_t id;
+	uint32_t idx;
 	struct sde_hw_blk *hw;
 };
 
+/**
+ * struct sde_rm_lm_conn - blocks hardwired to a layer mixer in the catalog
+ * @lm:		Layer mixer tracking item
+ * @dspp:	DSPP tracking item attached to the mixer, or NULL
+ * @ds:		Destination scaler tracking item attached to the mixer, or NULL
+ * @pp:		Pingpong tracking item attached to the mixer, or NULL
+ * @roi_misr:	ROI MISR tracking item attached to the mixer, or NULL
+ * @dsc:	DSC tracking item sharing the mixer's roi misr index, or NULL
+ * @peer_mask:	Bitmap of lm_conn indices which may be paired with this mixer
+ */
+struct sde_rm_lm_conn {
+	struct sde_rm_hw_blk *lm;
+	struct sde_rm_hw_blk *dspp;
+	struct sde_rm_hw_blk *ds;
+	struct sde_rm_hw_blk *pp;
+	struct sde_rm_hw_blk *roi_misr;
+	struct sde_rm_hw_blk *dsc;
+	unsigned long peer_mask;
+};
+
 /**
  * sde_rm_dbg_rsvp_stage - enum of steps in making reservation for event logging
  */
@@ -417,6 +451,9 @@ int sde_rm_destroy(struct sde_rm *rm)
 		}
 	}
 
+	kfree(rm->lm_conn);
+	rm->lm_conn = NULL;
+
 	sde_hw_mdp_destroy(rm->hw_mdp);
 	rm->hw_mdp = NULL;
 
@@ -501,11 +538,98 @@ static int _sde_rm_hw_blk_create(
 	blk->type = type;
 	blk->id = id;
 	blk->hw = hw;
+	if (rm->hw_blk_count[type] < RM_BLK_IDX_NONE)
+		blk->idx = rm->hw_blk_count[type]++;
+	else
+		blk->idx = RM_BLK_IDX_NONE;
 	list_add_tail(&blk->list, &rm->hw_blks[type]);
 
 	return 0;
 }
 
+static struct sde_rm_hw_blk *_sde_rm_find_blk(struct sde_rm *rm,
+		enum sde_hw_blk_type type, uint32_t id)
+{
+	struct sde_rm_hw_blk *blk;
+
+	list_for_each_entry(blk, &rm->hw_blks[type], list) {
+		if (blk->id == id)
+			return blk;
+	}
+
+	return NULL;
+}
+
+/**
+ * _sde_rm_init_lm_conn - resolve the blocks hardwired to each layer mixer
+ *	once, so that reservations don't have to search the block lists
+ * @rm: sde resource manager handle
+ * @Return: 0 on success, -ENOMEM on allocation failure
+ */
+static int _sde_rm_init_lm_conn(struct sde_rm *rm)
+{
+	struct sde_rm_hw_blk *lm, *peer;
+	struct sde_rm_lm_conn *conn;
+	const struct sde_lm_cfg *lm_cfg;
+
+	rm->lm_conn = kcalloc(rm->hw_blk_count[SDE_HW_BLK_LM],
+			sizeof(*rm->lm_conn), GFP_KERNEL);
+	if (!rm->lm_conn)
+		return -ENOMEM;
+
+	list_for_each_entry(lm, &rm->hw_blks[SDE_HW_BLK_LM], list) {
+		if (!RM_BLK_IDX_VALID(lm))
+			continue;
+
+		lm_cfg = to_sde_hw_mixer(lm->hw)->cap;
+		conn = &rm->lm_conn[lm->idx];
+		conn->lm = lm;
+		conn->dspp = _sde_rm_find_blk(rm, SDE_HW_BLK_DSPP,
+				lm_cfg->dspp);
+		conn->ds = _sde_rm_find_blk(rm, SDE_HW_BLK_DS, lm_cfg->ds);
+		conn->pp = _sde_rm_find_blk(rm, SDE_HW_BLK_PINGPONG,
+				lm_cfg->pingpong);
+		conn->roi_misr = _sde_rm_find_blk(rm, SDE_HW_BLK_ROI_MISR,
+				lm_cfg->roi_misr);
+		conn->dsc = _sde_rm_find_blk(rm, SDE_HW_BLK_DSC,
+				lm_cfg->roi_misr);
+
+		list_for_each_entry(peer, &rm->hw_blks[SDE_HW_BLK_LM], list) {
+			if (RM_BLK_IDX_VALID(peer) &&
+					test_bit(peer->id, &lm_cfg->lm_pair_mask))
+				set_bit(peer->idx, &conn->peer_mask);
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * _sde_rm_get_avail_mask - get the bitmap of catalog blocks of a type which
+ *	are not held by a reservation of another encoder
+ * @rm: sde resource manager handle
+ * @rsvp: reservation currently being created
+ * @type: hardware block type
+ * @Return: bitmap indexed by sde_rm_hw_blk idx
+ */
+static unsigned long _sde_rm_get_avail_mask(struct sde_rm *rm,
+		struct sde_rm_rsvp *rsvp, enum sde_hw_blk_type type)
+{
+	struct sde_rm_rsvp *r;
+	unsigned long busy = 0;
+	uint32_t count = rm->hw_blk_count[type];
+
+	list_for_each_entry(r, &rm->rsvps, list) {
+		if (r->enc_id != rsvp->enc_id)
+			busy |= r->blk_mask[type];
+	}
+
+	if (count < BITS_PER_LONG)
+		busy |= ~(BIT(count) - 1);
+
+	return ~busy;
+}
+
 int sde_rm_init(struct sde_rm *rm,
 		struct sde_mdss_cfg *cat,
 		void __iomem *mmio,
@@ -679,6 +803,12 @@ int sde_rm_init(struct sde_rm *rm,
 		}
 	}
 
+	rc = _sde_rm_init_lm_conn(rm);
+	if (rc) {
+		SDE_ERROR("failed to init lm connectivity table\n");
+		goto fail;
+	}
+
 	return 0;
 
 fail:
@@ -724,7 +854,7 @@ static bool _sde_rm_check_lm_and_get_connected_blks(
 	struct sde_kms *sde_kms = to_sde_kms(priv->kms);
 	const struct sde_lm_cfg *lm_cfg = to_sde_hw_mixer(lm->hw)->cap;
 	const struct sde_pingpong_cfg *pp_cfg;
-	struct sde_rm_hw_iter iter;
+	const struct sde_rm_lm_conn *conn = &rm->lm_conn[lm->idx];
 	bool is_valid_dspp, is_valid_ds, ret;
 	u32 display_pref, cwb_pref;
 
@@ -808,14 +938,7 @@ static bool _sde_rm_check_lm_and_get_connected_blks(
 	}
 
 	if (lm_cfg->dspp != DSPP_MAX) {
-		sde_rm_init_hw_iter(&iter, 0, SDE_HW_BLK_DSPP);
-		while (_sde_rm_get_hw_locked(rm, &iter)) {
-			if (iter.blk->id == lm_cfg->dspp) {
-				*dspp = iter.blk;
-				break;
-			}
-		}
-
+		*dspp = conn->dspp;
 		if (!*dspp) {
 			SDE_DEBUG("lm %d failed to retrieve dspp %d\n", lm->id,
 					lm_cfg->dspp);
@@ -830,14 +953,7 @@ static bool _sde_rm_check_lm_and_get_connected_blks(
 	}
 
 	if (lm_cfg->ds != DS_MAX) {
-		sde_rm_init_hw_iter(&iter, 0, SDE_HW_BLK_DS);
-		while (_sde_rm_get_hw_locked(rm, &iter)) {
-			if (iter.blk->id == lm_cfg->ds) {
-				*ds = iter.blk;
-				break;
-			}
-		}
-
+		*ds = conn->ds;
 		if (!*ds) {
 			SDE_DEBUG("lm %d failed to retrieve ds %d\n", lm->id,
 					lm_cfg->ds);
@@ -851,14 +967,7 @@ static bool _sde_rm_check_lm_and_get_connected_blks(
 		}
 	}
 
-	sde_rm_init_hw_iter(&iter, 0, SDE_HW_BLK_PINGPONG);
-	while (_sde_rm_get_hw_locked(rm, &iter)) {
-		if (iter.blk->id == lm_cfg->pingpong) {
-			*pp = iter.blk;
-			break;
-		}
-	}
-
+	*pp = conn->pp;
 	if (!*pp) {
 		SDE_ERROR("failed to get pp on lm %d\n", lm_cfg->pingpong);
 		return false;
@@ -873,14 +982,7 @@ static bool _sde_rm_check_lm_and_get_connected_blks(
 	}
 
 	if (lm_cfg->roi_misr != ROI_MISR_MAX) {
-		sde_rm_init_hw_iter(&iter, 0, SDE_HW_BLK_ROI_MISR);
-		while (_sde_rm_get_hw_locked(rm, &iter)) {
-			if (iter.blk->id == lm_cfg->roi_misr) {
-				*roi_misr = iter.blk;
-				break;
-			}
-		}
-
+		*roi_misr = conn->roi_misr;
 		if (!*roi_misr) {
 			SDE_ERROR("failed to get roi misr on lm %d\n",
 					lm_cfg->roi_misr);
@@ -916,14 +1018,7 @@ static bool _sde_rm_check_lm_and_get_connected_blks(
 	 */
 	if (reqs->topology->num_comp_enc
 		&& sde_kms->catalog->has_roi_misr) {
-		sde_rm_init_hw_iter(&iter, 0, SDE_HW_BLK_DSC);
-		while (_sde_rm_get_hw_locked(rm, &iter)) {
-			if (iter.blk->id == lm_cfg->roi_misr) {
-				*dsc = iter.blk;
-				break;
-			}
-		}
-
+		*dsc = conn->dsc;
 		if (!*dsc) {
 			SDE_ERROR("failed to get dsc on lm %d\n",
 					lm_cfg->roi_misr);
@@ -966,24 +1061,35 @@ static int _sde_rm_reserve_lms(
 	struct sde_rm_hw_blk *pp[MAX_BLOCKS];
 	struct sde_rm_hw_blk *roi_misr[MAX_BLOCKS];
 	struct sde_rm_hw_blk *dsc[MAX_BLOCKS];
-	struct sde_rm_hw_iter iter_i, iter_j;
-	u32 lm_mask = 0;
-	int lm_count = 0;
-	int i, rc = 0;
+	struct sde_rm_lm_conn *conn;
+	struct sde_rm_hw_iter iter_i;
+	unsigned long lm_mask = 0, avail_mask, peer_mask;
+	int lm_count = 0, num_lm;
+	int i, j, rc = 0;
+	bool peer_found;
 
 	if (!reqs->topology->num_lm) {
 		SDE_DEBUG("invalid number of lm: %d\n", reqs->topology->num_lm);
 		return 0;
 	}
 
+	/*
+	 * Only mixers not held by other encoders are candidates; the
+	 * hardwired blocks of each candidate come from the lm_conn table.
+	 */
+	num_lm = rm->hw_blk_count[SDE_HW_BLK_LM];
+	avail_mask = _sde_rm_get_avail_mask(rm, rsvp, SDE_HW_BLK_LM);
+
 	/* Find a primary mixer */
-	sde_rm_init_hw_iter(&iter_i, 0, SDE_HW_BLK_LM);
-	while (lm_count != reqs->topology->num_lm &&
-			_sde_rm_get_hw_locked(rm, &iter_i)) {
-		if (lm_mask & (1 << iter_i.blk->id))
+	for_each_set_bit(i, &avail_mask, num_lm) {
+		if (lm_count == reqs->topology->num_lm)
+			break;
+
+		if (test_bit(i, &lm_mask))
 			continue;
 
-		lm[lm_count] = iter_i.blk;
+		conn = &rm->lm_conn[i];
+		lm[lm_count] = conn->lm;
 		dspp[lm_count] = NULL;
 		ds[lm_count] = NULL;
 		pp[lm_count] = NULL;
@@ -991,7 +1097,7 @@ static int _sde_rm_reserve_lms(
 		dsc[lm_count] = NULL;
 
 		SDE_DEBUG("blk id = %d, _lm_ids[%d] = %d\n",
-			iter_i.blk->id,
+			conn->lm->id,
 			lm_count,
 			_lm_ids ? _lm_ids[lm_count] : -1);
 
@@ -1005,7 +1111,7 @@ static int _sde_rm_reserve_lms(
 				&dsc[lm_count], NULL))
 			continue;
 
-		lm_mask |= (1 << iter_i.blk->id);
+		set_bit(i, &lm_mask);
 		++lm_count;
 
 		/* Return if peer is not needed */
@@ -1013,41 +1119,40 @@ static int _sde_rm_reserve_lms(
 			break;
 
 		/* Valid primary mixer found, find matching peers */
-		sde_rm_init_hw_iter(&iter_j, 0, SDE_HW_BLK_LM);
-
-		while (_sde_rm_get_hw_locked(rm, &iter_j)) {
-			if (lm_mask & (1 << iter_j.blk->id))
-				continue;
+		peer_mask = avail_mask & conn->peer_mask & ~lm_mask;
+		peer_found = false;
 
-			lm[lm_count] = iter_j.blk;
+		for_each_set_bit(j, &peer_mask, num_lm) {
+			lm[lm_count] = rm->lm_conn[j].lm;
 			dspp[lm_count] = NULL;
 			ds[lm_count] = NULL;
 			pp[lm_count] = NULL;
 			roi_misr[lm_count] = NULL;
 
 			if (!_sde_rm_check_lm_and_get_connected_blks(
-					rm, rsvp, reqs, iter_j.blk,
+					rm, rsvp, reqs, lm[lm_count],
 					&dspp[lm_count], &ds[lm_count],
 					&pp[lm_count], &roi_misr[lm_count],
-					&dsc[lm_count], iter_i.blk))
+					&dsc[lm_count], conn->lm))
 				continue;
 
 			SDE_DEBUG("blk id = %d, _lm_ids[%d] = %d\n",
-				iter_j.blk->id,
+				lm[lm_count]->id,
 				lm_count,
 				_lm_ids ? _lm_ids[lm_count] : -1);
 
 			if (_lm_ids && (lm[lm_count])->id != _lm_ids[lm_count])
 				continue;
 
-			lm_mask |= (1 << iter_j.blk->id);
+			set_bit(j, &lm_mask);
 			++lm_count;
+			peer_found = true;
 			break;
 		}
 
 		/* Rollback primary LM if peer is not found */
-		if (!iter_j.hw) {
-			lm_mask &= ~(1 << iter_i.blk->id);
+		if (!peer_found) {
+			clear_bit(i, &lm_mask);
 			--lm_count;
 		}
 	}
@@ -1787,6 +1892,24 @@ static int _sde_rm_populate_requirements(
 	return 0;
 }
 
+static bool _sde_rm_reqs_match(const struct sde_rm_requirements *a,
+		const struct sde_rm_requirements *b)
+{
+	const struct sde_encoder_hw_resources *ra = &a->hw_res;
+	const struct sde_encoder_hw_resources *rb = &b->hw_res;
+
+	return a->top_ctrl == b->top_ctrl &&
+		a->topology == b->topology &&
+		!memcmp(ra->intfs, rb->intfs, sizeof(ra->intfs)) &&
+		!memcmp(ra->wbs, rb->wbs, sizeof(ra->wbs)) &&
+		ra->needs_cdm == rb->needs_cdm &&
+		ra->display_num_of_h_tiles == rb->display_num_of_h_tiles &&
+		ra->is_primary == rb->is_primary &&
+		ra->topology.num_lm == rb->topology.num_lm &&
+		ra->topology.num_enc == rb->topology.num_enc &&
+		ra->topology.num_intf == rb->topology.num_intf;
+}
+
 static struct sde_rm_rsvp *_sde_rm_get_rsvp(
 		struct sde_rm *rm,
 		struct drm_encoder *enc)
@@ -1950,6 +2073,9 @@ static int _sde_rm_commit_rsvp(
 			if (blk->rsvp_nxt) {
 				blk->rsvp = blk->rsvp_nxt;
 				blk->rsvp_nxt = NULL;
+				if (RM_BLK_IDX_VALID(blk))
+					set_bit(blk->idx,
+						&blk->rsvp->blk_mask[type]);
 			}
 		}
 	}
@@ -2039,13 +2165,32 @@ int sde_rm_reserve(
 	 * If reservation is successful, and we're not in test-only, then we
 	 * replace the current with the next.
 	 */
+	rsvp_cur = _sde_rm_get_rsvp(rm, enc);
+
+	/*
+	 * If the requirements match those of the committed reservation, it
+	 * already satisfies them and no other display can hold its blocks,
+	 * so keep it rather than building and swapping in an identical one.
+	 */
+	if (rsvp_cur && !(test_only && RM_RQ_CLEAR(&reqs)) &&
+			!sde_rm_is_display_in_cont_splash(sde_kms, enc) &&
+			_sde_rm_reqs_match(&rsvp_cur->reqs, &reqs)) {
+		rm->rsvp_cache_hits++;
+		SDE_DEBUG("reuse rsvp[s%de%d]\n", rsvp_cur->seq,
+				rsvp_cur->enc_id);
+		SDE_EVT32(enc->base.id, rsvp_cur->seq, test_only,
+				rm->rsvp_cache_hits);
+		goto end;
+	}
+
+	rm->rsvp_full_count++;
+
 	rsvp_nxt = kzalloc(sizeof(*rsvp_nxt), GFP_KERNEL);
 	if (!rsvp_nxt) {
 		ret = -ENOMEM;
 		goto end;
 	}
-
-	rsvp_cur = _sde_rm_get_rsvp(rm, enc);
+	rsvp_nxt->reqs = reqs;
 
 	/*
 	 * User can request that we clear out any reservation during the
@@ -2144,6 +2289,7 @@ int sde_rm_ext_blk_create_reserve(struct sde_rm *rm,
 
 	blk->type = hw->type;
 	blk->id = hw->id;
+	blk->idx = RM_BLK_IDX_NONE;
 	blk->hw = hw;
 	blk->rsvp = rsvp;
 	list_add_tail(&blk->list, &rm->hw_blks[hw->type]);
@@ -2197,3 +2343,31 @@ end:
 	mutex_unlock(&rm->rm_lock);
 	return ret;
 }
+
+#ifdef CONFIG_DEBUG_FS
+int sde_rm_debugfs_init(struct sde_rm *rm, struct dentry *parent)
+{
+	struct dentry *entry;
+
+	if (!rm || !parent)
+		return -EINVAL;
+
+	entry = debugfs_create_dir("rm", parent);
+	if (IS_ERR_OR_NULL(entry)) {
+		SDE_ERROR("failed to create rm debugfs\n");
+		return -EINVAL;
+	}
+
+	debugfs_create_u32("rsvp_cache_hits", 0400, entry,
+			&rm->rsvp_cache_hits);
+	debugfs_create_u32("rsvp_full_count", 0400, entry,
+			&rm->rsvp_full_count);
+
+	return 0;
+}
+#else
+int sde_rm_debugfs_init(struct sde_rm *rm, struct dentry *parent)
+{
+	return 0;
+}
+#endif
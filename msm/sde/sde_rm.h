@@ -110,6 +110,12 @@ struct sde_rm_topology_def {
  * @lm_max_width: cached layer mixer maximum width
  * @rsvp_next_seq: sequence number for next reservation for debugging purposes
  * @rm_lock: resource manager mutex
+ * @hw_blk_count: number of catalog hardware blocks per type, which are also
+ *	the bit indices used by the reservation bitmaps
+ * @lm_conn: per layer mixer table of hardwired blocks, built from catalog
+ * @rsvp_cache_hits: number of reserve calls satisfied by the committed
+ *	reservation because the requirements were unchanged
+ * @rsvp_full_count: number of reserve calls which built a new reservation
  */
 struct sde_rm {
 	struct drm_device *dev;
@@ -120,6 +126,10 @@ struct sde_rm {
 	uint32_t rsvp_next_seq;
 	struct mutex rm_lock;
 	const struct sde_rm_topology_def *topology_tbl;
+	uint32_t hw_blk_count[SDE_HW_BLK_MAX];
+	struct sde_rm_lm_conn *lm_conn;
+	u32 rsvp_cache_hits;
+	u32 rsvp_full_count;
 };
 
 /**
@@ -128,6 +138,12 @@ struct sde_rm {
  */
 struct sde_rm_hw_blk;
 
+/**
+ *  struct sde_rm_lm_conn - resource manager internal structure
+ *	forward declaration for the layer mixer connectivity table
+ */
+struct sde_rm_lm_conn;
+
 /**
  * struct sde_rm_hw_iter - iterator for use with sde_rm
  * @hw: sde_hw object requested, or NULL on failure
@@ -203,6 +219,14 @@ int sde_rm_init(struct sde_rm *rm,
  */
 int sde_rm_destroy(struct sde_rm *rm);
 
+/**
+ * sde_rm_debugfs_init - Create debugfs nodes for resource manager statistics
+ * @rm: SDE Resource Manager handle
+ * @parent: Pointer to parent debugfs
+ * @Return: 0 on Success otherwise -ERROR
+ */
+int sde_rm_debugfs_init(struct sde_rm *rm, struct dentry *parent);
+
 /**
  * sde_rm_reserve - Given a CRTC->Encoder->Connector display chain, analyze
  *	the use connections and user requirements, specified through related
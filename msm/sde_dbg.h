@@ -9,6 +9,7 @@
 #include <stdarg.h>
 #include <linux/debugfs.h>
 #include <linux/list.h>
+#include <asm/local.h>
 
 /* select an uncommon hex value for the limiter */
 #define SDE_EVTLOG_DATA_LIMITER	(0xC0DEBEEF)
@@ -77,29 +78,76 @@ struct sde_dbg_power_ctrl {
 	int (*enable_fn)(void *handle, void *client, bool enable);
 };
 
+/**
+ * @time: local_clock() timestamp of the event in nanoseconds
+ * @seq: ring sequence number + 1 of the entry, 0 while being written
+ */
 struct sde_dbg_evtlog_log {
-	s64 time;
+	u64 time;
 	const char *name;
 	int line;
 	u32 data[SDE_EVTLOG_MAX_DATA];
 	u32 data_cnt;
 	int pid;
+	u32 seq;
+};
+
+/*
+ * each cpu logs into its own ring of this many entries, must be a power
+ * of two so ring positions can be masked; sized like the old shared log
+ * so a single busy cpu keeps the full history
+ */
+#define SDE_EVTLOG_CPU_ENTRY	SDE_EVTLOG_ENTRY
+
+/**
+ * struct sde_dbg_evtlog_ring - per-cpu lock-free event ring
+ * @logs: ring entries
+ * @head: number of entries reserved on this ring since init
+ * @dump_pos: next ring position to output in the current dump
+ * @dump_end: end ring position of the current dump
+ * @last_dump: end ring position of the last completed dump
+ */
+struct sde_dbg_evtlog_ring {
+	struct sde_dbg_evtlog_log logs[SDE_EVTLOG_CPU_ENTRY];
+	local_t head;
+	u32 dump_pos;
+	u32 dump_end;
+	u32 last_dump;
+};
+
+#define SDE_EVTLOG_FILTER_HASH_BITS	8
+
+/**
+ * struct sde_evtlog_filter_cache - cached filter decision for a call site
+ * @name: function name pointer of the call site
+ * @tag: filter generation << 1 | filtered, 0 if invalid
+ */
+struct sde_evtlog_filter_cache {
+	const char *name;
+	u32 tag;
 };
 
 /**
- * @last_dump: Index of last entry to be output during evtlog dumps
+ * @rings: per-cpu event rings, indexed by cpu id
+ * @dump_idx: index of the next entry output by the current dump
+ * @dump_prev_time: timestamp of the previously output entry
+ * @spin_lock: protects filter list and dump state, not taken on log path
  * @filter_list: Linked list of currently active filter strings
+ * @filter_cnt: number of active filter strings
+ * @filter_gen: generation of filter list, bumped on every change
+ * @filter_cache: call site filter decisions, hashed by function name
  */
 struct sde_dbg_evtlog {
-	struct sde_dbg_evtlog_log logs[SDE_EVTLOG_ENTRY];
-	u32 first;
-	u32 last;
-	u32 last_dump;
-	u32 curr;
-	u32 next;
+	struct sde_dbg_evtlog_ring *rings;
+	u32 dump_idx;
+	u64 dump_prev_time;
 	u32 enable;
 	spinlock_t spin_lock;
 	struct list_head filter_list;
+	int filter_cnt;
+	atomic_t filter_gen;
+	struct sde_evtlog_filter_cache
+			filter_cache[1 << SDE_EVTLOG_FILTER_HASH_BITS];
 };
 
 extern struct sde_dbg_evtlog *sde_dbg_base_evtlog;
@@ -12,6 +12,9 @@
 #include <linux/uaccess.h>
 #include <linux/dma-buf.h>
 #include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/hash.h>
+#include <linux/sched/clock.h>
 
 #include "sde_dbg.h"
 #include "sde_trace.h"
@@ -49,6 +52,51 @@ static bool _sde_evtlog_is_filtered_no_lock(
 	return rc;
 }
 
+/*
+ * Filter decisions are cached per call site, keyed by the __func__ pointer,
+ * so the substring walk over the filter list only runs once per call site
+ * and filter generation.
+ */
+static bool _sde_evtlog_is_filtered(struct sde_dbg_evtlog *evtlog,
+		const char *str)
+{
+	struct sde_evtlog_filter_cache *entry;
+	unsigned long flags;
+	u32 gen, tag;
+	bool rc;
+
+	if (!str)
+		return true;
+
+	if (!READ_ONCE(evtlog->filter_cnt))
+		return false;
+
+	gen = atomic_read(&evtlog->filter_gen);
+	entry = &evtlog->filter_cache[hash_ptr(str,
+			SDE_EVTLOG_FILTER_HASH_BITS)];
+
+	tag = READ_ONCE(entry->tag);
+	smp_rmb();
+	if (READ_ONCE(entry->name) == str && (tag >> 1) == gen) {
+		smp_rmb();
+		if (READ_ONCE(entry->tag) == tag)
+			return tag & 0x1;
+	}
+
+	spin_lock_irqsave(&evtlog->spin_lock, flags);
+	rc = _sde_evtlog_is_filtered_no_lock(evtlog, str);
+	gen = atomic_read(&evtlog->filter_gen);
+
+	WRITE_ONCE(entry->tag, 0);
+	smp_wmb();
+	WRITE_ONCE(entry->name, str);
+	smp_wmb();
+	WRITE_ONCE(entry->tag, (gen << 1) | rc);
+	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
+
+	return rc;
+}
+
 bool sde_evtlog_is_enabled(struct sde_dbg_evtlog *evtlog, u32 flag)
 {
 	return evtlog && (evtlog->enable & flag);
@@ -57,10 +105,11 @@ bool sde_evtlog_is_enabled(struct sde_dbg_evtlog *evtlog, u32 flag)
 void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 		int flag, ...)
 {
-	unsigned long flags;
-	int i, val = 0;
+	int i, val = 0, cpu;
 	va_list args;
+	struct sde_dbg_evtlog_ring *ring;
 	struct sde_dbg_evtlog_log *log;
+	u32 pos;
 
 	if (!evtlog)
 		return;
@@ -68,16 +117,24 @@ void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 	if (!sde_evtlog_is_enabled(evtlog, flag))
 		return;
 
-	spin_lock_irqsave(&evtlog->spin_lock, flags);
+	if (_sde_evtlog_is_filtered(evtlog, name))
+		return;
 
-	if (_sde_evtlog_is_filtered_no_lock(evtlog, name))
-		goto exit;
+	/*
+	 * Reserve a slot on this cpu's ring; an interrupt logging on top of
+	 * us reserves the next slot, so no lock or irq masking is needed.
+	 */
+	cpu = get_cpu();
+	ring = &evtlog->rings[cpu];
+	pos = (u32)local_inc_return(&ring->head) - 1;
+	log = &ring->logs[pos & (SDE_EVTLOG_CPU_ENTRY - 1)];
 
-	log = &evtlog->logs[evtlog->curr];
-	log->time = ktime_to_us(ktime_get());
+	WRITE_ONCE(log->seq, 0);
+	smp_wmb();
+
+	log->time = local_clock();
 	log->name = name;
 	log->line = line;
-	log->data_cnt = 0;
 	log->pid = current->pid;
 
 	va_start(args, flag);
@@ -91,46 +148,103 @@ void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 	}
 	va_end(args);
 	log->data_cnt = i;
-	evtlog->curr = (evtlog->curr + 1) % SDE_EVTLOG_ENTRY;
-	evtlog->last++;
+
+	smp_wmb();
+	WRITE_ONCE(log->seq, pos + 1);
 
 	trace_sde_evtlog(name, line, log->data_cnt, log->data);
-exit:
-	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
+	put_cpu();
+}
+
+/*
+ * copy out the oldest pending entry across all cpu rings, skipping entries
+ * that were overwritten or are still being written
+ */
+static bool _sde_evtlog_dump_next(struct sde_dbg_evtlog *evtlog,
+		struct sde_dbg_evtlog_log *out)
+{
+	struct sde_dbg_evtlog_ring *ring, *oldest_ring;
+	struct sde_dbg_evtlog_log *log;
+	u32 seq;
+	int cpu;
+
+	do {
+		oldest_ring = NULL;
+		for_each_possible_cpu(cpu) {
+			ring = &evtlog->rings[cpu];
+			if (ring->dump_pos == ring->dump_end)
+				continue;
+
+			log = &ring->logs[ring->dump_pos &
+					(SDE_EVTLOG_CPU_ENTRY - 1)];
+			if (!oldest_ring || log->time < out->time) {
+				oldest_ring = ring;
+				out->time = log->time;
+			}
+		}
+
+		if (!oldest_ring)
+			return false;
+
+		log = &oldest_ring->logs[oldest_ring->dump_pos &
+				(SDE_EVTLOG_CPU_ENTRY - 1)];
+		seq = READ_ONCE(log->seq);
+		smp_rmb();
+		*out = *log;
+		smp_rmb();
+		if (seq == oldest_ring->dump_pos + 1 &&
+				READ_ONCE(log->seq) == seq) {
+			out->seq = seq;
+			oldest_ring->dump_pos++;
+			return true;
+		}
+
+		oldest_ring->dump_pos++;
+	} while (true);
 }
 
 /* always dump the last entries which are not dumped yet */
 static bool _sde_evtlog_dump_calc_range(struct sde_dbg_evtlog *evtlog,
-		bool update_last_entry, bool full_dump)
+		bool update_last_entry, bool full_dump,
+		struct sde_dbg_evtlog_log *log)
 {
 	int max_entries = full_dump ? SDE_EVTLOG_ENTRY : SDE_EVTLOG_PRINT_ENTRY;
+	struct sde_dbg_evtlog_ring *ring;
+	struct sde_dbg_evtlog_log skipped;
+	u32 start, end, pending = 0, skip = 0;
+	int cpu;
 
 	if (!evtlog)
 		return false;
 
-	evtlog->first = evtlog->next;
-
-	if (update_last_entry)
-		evtlog->last_dump = evtlog->last;
+	if (update_last_entry) {
+		for_each_possible_cpu(cpu) {
+			ring = &evtlog->rings[cpu];
+			end = (u32)local_read(&ring->head);
+			start = full_dump ? 0 : ring->last_dump;
+			if (end - start > SDE_EVTLOG_CPU_ENTRY)
+				start = end - SDE_EVTLOG_CPU_ENTRY;
+
+			ring->dump_pos = start;
+			ring->dump_end = end;
+			ring->last_dump = end;
+			pending += end - start;
+		}
 
-	if (evtlog->last_dump == evtlog->first)
-		return false;
+		evtlog->dump_idx = 0;
+		evtlog->dump_prev_time = 0;
 
-	if (evtlog->last_dump < evtlog->first) {
-		evtlog->first %= SDE_EVTLOG_ENTRY;
-		if (evtlog->last_dump < evtlog->first)
-			evtlog->last_dump += SDE_EVTLOG_ENTRY;
-	}
+		while (pending > max_entries + skip &&
+				_sde_evtlog_dump_next(evtlog, &skipped)) {
+			evtlog->dump_prev_time = skipped.time;
+			skip++;
+		}
 
-	if ((evtlog->last_dump - evtlog->first) > max_entries) {
-		pr_info("evtlog skipping %d entries, last=%d\n",
-			evtlog->last_dump - evtlog->first -
-			max_entries, evtlog->last_dump - 1);
-		evtlog->first = evtlog->last_dump - max_entries;
+		if (skip)
+			pr_info("evtlog skipping %d entries\n", skip);
 	}
-	evtlog->next = evtlog->first + 1;
 
-	return true;
+	return _sde_evtlog_dump_next(evtlog, log);
 }
 
 ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
@@ -139,8 +253,9 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 {
 	int i;
 	ssize_t off = 0;
-	struct sde_dbg_evtlog_log *log, *prev_log;
+	struct sde_dbg_evtlog_log log;
 	unsigned long flags;
+	u64 time_us, delta_us;
 
 	if (!evtlog || !evtlog_buf)
 		return 0;
@@ -148,15 +263,16 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 	spin_lock_irqsave(&evtlog->spin_lock, flags);
 
 	/* update markers, exit if nothing to print */
-	if (!_sde_evtlog_dump_calc_range(evtlog, update_last_entry, full_dump))
+	if (!_sde_evtlog_dump_calc_range(evtlog, update_last_entry, full_dump,
+			&log))
 		goto exit;
 
-	log = &evtlog->logs[evtlog->first % SDE_EVTLOG_ENTRY];
-
-	prev_log = &evtlog->logs[(evtlog->first - 1) % SDE_EVTLOG_ENTRY];
+	time_us = div_u64(log.time, NSEC_PER_USEC);
+	delta_us = evtlog->dump_prev_time ?
+		div_u64(log.time - evtlog->dump_prev_time, NSEC_PER_USEC) : 0;
 
 	off = snprintf((evtlog_buf + off), (evtlog_buf_size - off), "%s:%-4d",
-		log->name, log->line);
+		log.name, log.line);
 
 	if (off < SDE_EVTLOG_BUF_ALIGN) {
 		memset((evtlog_buf + off), 0x20, (SDE_EVTLOG_BUF_ALIGN - off));
@@ -164,14 +280,17 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 	}
 
 	off += snprintf((evtlog_buf + off), (evtlog_buf_size - off),
-		"=>[%-8d:%-11llu:%9llu][%-4d]:", evtlog->first,
-		log->time, (log->time - prev_log->time), log->pid);
+		"=>[%-8d:%-11llu:%9llu][%-4d]:", evtlog->dump_idx,
+		time_us, delta_us, log.pid);
 
-	for (i = 0; i < log->data_cnt; i++)
+	for (i = 0; i < log.data_cnt; i++)
 		off += snprintf((evtlog_buf + off), (evtlog_buf_size - off),
-			"%x ", log->data[i]);
+			"%x ", log.data[i]);
 
 	off += snprintf((evtlog_buf + off), (evtlog_buf_size - off), "\n");
+
+	evtlog->dump_idx++;
+	evtlog->dump_prev_time = log.time;
 exit:
 	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 
@@ -201,8 +320,15 @@ struct sde_dbg_evtlog *sde_evtlog_init(void)
 	if (!evtlog)
 		return ERR_PTR(-ENOMEM);
 
+	evtlog->rings = vzalloc(nr_cpu_ids * sizeof(*evtlog->rings));
+	if (!evtlog->rings) {
+		kfree(evtlog);
+		return ERR_PTR(-ENOMEM);
+	}
+
 	spin_lock_init(&evtlog->spin_lock);
 	evtlog->enable = SDE_EVTLOG_DEFAULT_ENABLE;
+	atomic_set(&evtlog->filter_gen, 1);
 
 	INIT_LIST_HEAD(&evtlog->filter_list);
 
@@ -255,6 +381,8 @@ void sde_evtlog_set_filter(struct sde_dbg_evtlog *evtlog, char *filter)
 		list_del_init(&filter_node->list);
 		list_add_tail(&filter_node->list, &free_list);
 	}
+	WRITE_ONCE(evtlog->filter_cnt, 0);
+	atomic_inc(&evtlog->filter_gen);
 	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 
 	/*
@@ -285,6 +413,8 @@ void sde_evtlog_set_filter(struct sde_dbg_evtlog *evtlog, char *filter)
 
 		spin_lock_irqsave(&evtlog->spin_lock, flags);
 		list_add_tail(&filter_node->list, &evtlog->filter_list);
+		WRITE_ONCE(evtlog->filter_cnt, evtlog->filter_cnt + 1);
+		atomic_inc(&evtlog->filter_gen);
 		spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 	}
 
@@ -308,5 +438,6 @@ void sde_evtlog_destroy(struct sde_dbg_evtlog *evtlog)
 		list_del(&filter_node->list);
 		kfree(filter_node);
 	}
+	vfree(evtlog->rings);
 	kfree(evtlog);
 }
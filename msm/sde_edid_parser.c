@@ -5,6 +5,7 @@
 
 #include <drm/drm_edid.h>
 #include <linux/hdmi.h>
+#include <linux/crc32.h>
 
 #include "sde_kms.h"
 #include "sde_edid_parser.h"
@@ -504,6 +505,113 @@ static void _sde_edid_extract_speaker_allocation_data(
 	SDE_EDID_DEBUG("%s -", __func__);
 }
 
+static u32 _sde_edid_hash(struct edid *edid)
+{
+	return crc32_le(~0, (u8 *)edid, EDID_LENGTH * (edid->extensions + 1));
+}
+
+static void _sde_edid_free_cached_modes(struct sde_edid_mode_cache *cache)
+{
+	struct drm_display_mode *mode, *tmp;
+
+	list_for_each_entry_safe(mode, tmp, &cache->modes, head) {
+		list_del(&mode->head);
+		drm_mode_destroy(cache->dev, mode);
+	}
+
+	cache->connector = NULL;
+	cache->num_modes = 0;
+}
+
+/*
+ * Replay the modes and connector info parsed from an identical EDID on
+ * the same connector. Returns false if the EDID was not seen last.
+ */
+static bool _sde_edid_restore_modes(struct drm_connector *connector,
+		struct sde_edid_ctrl *edid_ctrl, u32 hash, int *num_modes)
+{
+	struct sde_edid_mode_cache *cache = edid_ctrl->mode_cache;
+	struct drm_display_info *info = &connector->display_info;
+	struct drm_display_mode *mode, *dup;
+	const u32 *bus_formats;
+	unsigned int num_bus_formats;
+
+	if (!cache || cache->connector != connector || cache->hash != hash ||
+			cache->checksum != sde_get_edid_checksum(edid_ctrl))
+		return false;
+
+	list_for_each_entry(mode, &cache->modes, head) {
+		dup = drm_mode_duplicate(connector->dev, mode);
+		if (!dup)
+			break;
+
+		drm_mode_probed_add(connector, dup);
+	}
+
+	/* bus formats are owned by the connector, not parsed from EDID */
+	bus_formats = info->bus_formats;
+	num_bus_formats = info->num_bus_formats;
+	*info = cache->display_info;
+	info->bus_formats = bus_formats;
+	info->num_bus_formats = num_bus_formats;
+
+	memcpy(connector->eld, cache->eld, sizeof(connector->eld));
+	memcpy(connector->latency_present, cache->latency_present,
+			sizeof(connector->latency_present));
+	memcpy(connector->video_latency, cache->video_latency,
+			sizeof(connector->video_latency));
+	memcpy(connector->audio_latency, cache->audio_latency,
+			sizeof(connector->audio_latency));
+
+	*num_modes = cache->num_modes;
+	SDE_EDID_DEBUG("%s: reused %d modes\n", __func__, *num_modes);
+
+	return true;
+}
+
+static void _sde_edid_store_modes(struct drm_connector *connector,
+		struct sde_edid_ctrl *edid_ctrl, u32 hash, int num_modes)
+{
+	struct sde_edid_mode_cache *cache = edid_ctrl->mode_cache;
+	struct drm_display_mode *mode, *dup;
+
+	if (!cache) {
+		cache = kzalloc(sizeof(*cache), GFP_KERNEL);
+		if (!cache)
+			return;
+
+		INIT_LIST_HEAD(&cache->modes);
+		edid_ctrl->mode_cache = cache;
+	} else if (cache->connector) {
+		_sde_edid_free_cached_modes(cache);
+	}
+
+	cache->dev = connector->dev;
+	cache->connector = connector;
+
+	list_for_each_entry(mode, &connector->probed_modes, head) {
+		dup = drm_mode_duplicate(connector->dev, mode);
+		if (!dup) {
+			_sde_edid_free_cached_modes(cache);
+			return;
+		}
+
+		list_add_tail(&dup->head, &cache->modes);
+	}
+
+	cache->hash = hash;
+	cache->checksum = sde_get_edid_checksum(edid_ctrl);
+	cache->num_modes = num_modes;
+	cache->display_info = connector->display_info;
+	memcpy(cache->eld, connector->eld, sizeof(cache->eld));
+	memcpy(cache->latency_present, connector->latency_present,
+			sizeof(cache->latency_present));
+	memcpy(cache->video_latency, connector->video_latency,
+			sizeof(cache->video_latency));
+	memcpy(cache->audio_latency, connector->audio_latency,
+			sizeof(cache->audio_latency));
+}
+
 struct sde_edid_ctrl *sde_edid_init(void)
 {
 	struct sde_edid_ctrl *edid_ctrl = NULL;
@@ -534,6 +642,13 @@ void sde_edid_deinit(void **input)
 
 	SDE_EDID_DEBUG("%s +", __func__);
 	sde_free_edid((void *)&edid_ctrl);
+
+	if (edid_ctrl->mode_cache) {
+		if (edid_ctrl->mode_cache->connector)
+			_sde_edid_free_cached_modes(edid_ctrl->mode_cache);
+		kfree(edid_ctrl->mode_cache);
+	}
+
 	kfree(edid_ctrl);
 	SDE_EDID_DEBUG("%s -", __func__);
 }
@@ -546,12 +661,18 @@ int _sde_edid_update_modes(struct drm_connector *connector,
 
 	SDE_EDID_DEBUG("%s +", __func__);
 	if (edid_ctrl->edid) {
+		u32 hash = _sde_edid_hash(edid_ctrl->edid);
+
 		drm_mode_connector_update_edid_property(connector,
 			edid_ctrl->edid);
 
+		if (_sde_edid_restore_modes(connector, edid_ctrl, hash, &rc))
+			return rc;
+
 		rc = drm_add_edid_modes(connector, edid_ctrl->edid);
 		sde_edid_set_mode_format(connector, edid_ctrl);
 		_sde_edid_update_dc_modes(connector, edid_ctrl);
+		_sde_edid_store_modes(connector, edid_ctrl, hash, rc);
 		SDE_EDID_DEBUG("%s -", __func__);
 		return rc;
 	}
@@ -604,6 +725,14 @@ void sde_parse_edid(void *input)
 	edid_ctrl = (struct sde_edid_ctrl *)(input);
 
 	if (edid_ctrl->edid) {
+		u32 hash = _sde_edid_hash(edid_ctrl->edid);
+
+		/* vendor and audio blocks are still those of this EDID */
+		if (edid_ctrl->parsed && edid_ctrl->parsed_hash == hash)
+			return;
+
+		edid_ctrl->parsed_hash = hash;
+		edid_ctrl->parsed = true;
 		sde_edid_extract_vendor_id(edid_ctrl);
 		_sde_edid_extract_audio_data_blocks(edid_ctrl);
 		_sde_edid_extract_speaker_allocation_data(edid_ctrl);
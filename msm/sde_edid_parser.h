@@ -70,6 +70,34 @@ struct sde_edid_sink_caps {
 	bool ind_view_support;
 };
 
+/*
+ * struct sde_edid_mode_cache - modes parsed from the last EDID seen
+ * @hash: crc32 of all EDID blocks
+ * @checksum: checksum byte of the last EDID block
+ * @dev: drm device the cached modes belong to
+ * @connector: connector the modes were parsed for
+ * @modes: copies of the probed modes after YUV/DC flag updates
+ * @num_modes: number of modes returned by drm_add_edid_modes
+ * @display_info: connector display info after parsing
+ * @eld: connector ELD after parsing
+ * @latency_present: connector latency flags after parsing
+ * @video_latency: connector video latency after parsing
+ * @audio_latency: connector audio latency after parsing
+ */
+struct sde_edid_mode_cache {
+	u32 hash;
+	u8 checksum;
+	struct drm_device *dev;
+	struct drm_connector *connector;
+	struct list_head modes;
+	int num_modes;
+	struct drm_display_info display_info;
+	u8 eld[MAX_ELD_BYTES];
+	bool latency_present[2];
+	int video_latency[2];
+	int audio_latency[2];
+};
+
 struct sde_edid_ctrl {
 	struct edid *edid;
 	u8 pt_scan_info;
@@ -83,6 +111,9 @@ struct sde_edid_ctrl {
 	char vendor_id[EDID_VENDOR_ID_SIZE];
 	struct sde_edid_sink_caps sink_caps;
 	struct sde_edid_hdr_data hdr_data;
+	u32 parsed_hash;
+	bool parsed;
+	struct sde_edid_mode_cache *mode_cache;
 };
 
 /**
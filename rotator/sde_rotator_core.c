@@ -1193,14 +1193,63 @@ static void sde_rotator_deinit_queue(struct sde_rot_mgr *mgr)
 	mgr->queue_count = 0;
 }
 
+static u64 sde_rotator_entry_load(struct sde_rot_entry *entry)
+{
+	return (u64)entry->item.src_rect.w * entry->item.src_rect.h;
+}
+
+/*
+ * sde_rotator_select_queue() - Function select hw queue for rotation work
+ * @mgr:	Rotator manager.
+ * @entry:	Contains details on rotator work item being requested
+ * @perf:	Session performance struct of the work item
+ *
+ * Inline (non-immediate trigger) work is bound by the display deadline and
+ * always goes to the highest priority queue. Work of a session that still
+ * has entries assigned or in flight stays on the same queue, so all entries
+ * of a request and the session complete in order. Otherwise the least
+ * loaded queue that is not of higher priority than requested is picked,
+ * preferring the requested priority on ties.
+ */
+static u32 sde_rotator_select_queue(struct sde_rot_mgr *mgr,
+	struct sde_rot_entry *entry, struct sde_rot_perf *perf)
+{
+	struct sde_rotation_item *item = &entry->item;
+	u32 wb_idx = item->wb_idx;
+	u32 i, sel;
+
+	if (wb_idx >= mgr->queue_count) {
+		/* assign to the lowest priority queue */
+		wb_idx = mgr->queue_count - 1;
+	}
+
+	if (item->trigger != SDE_ROTATOR_TRIGGER_IMMEDIATE)
+		return 0;
+
+	if (perf->assigned_count && perf->last_wb_idx < mgr->queue_count)
+		return perf->last_wb_idx;
+
+	for (i = wb_idx; i < mgr->queue_count; i++)
+		if (perf->work_distribution[i])
+			return i;
+
+	sel = wb_idx;
+	for (i = wb_idx + 1; i < mgr->queue_count; i++)
+		if (mgr->commitq[i].pending_load <
+				mgr->commitq[sel].pending_load)
+			sel = i;
+
+	return sel;
+}
+
 /*
  * sde_rotator_assign_queue() - Function assign rotation work onto hw
  * @mgr:	Rotator manager.
  * @entry:	Contains details on rotator work item being requested
  * @private:	Private struct used for access rot session performance struct
  *
- * This Function allocates hw required to complete rotation work item
- * requested.
+ * This Function selects a hw queue and allocates hw required to complete
+ * rotation work item requested.
  *
  * Caller is responsible for calling cleanup function if error is returned
  */
@@ -1212,51 +1261,54 @@ static int sde_rotator_assign_queue(struct sde_rot_mgr *mgr,
 	struct sde_rot_queue *queue;
 	struct sde_rot_hw_resource *hw;
 	struct sde_rotation_item *item = &entry->item;
-	u32 wb_idx = item->wb_idx;
 	u32 pipe_idx = item->pipe_idx;
-	int ret = 0;
+	u32 wb_idx;
 
-	if (wb_idx >= mgr->queue_count) {
-		/* assign to the lowest priority queue */
-		wb_idx = mgr->queue_count - 1;
+	perf = sde_rotator_find_session(private, item->session_id);
+	if (!perf) {
+		SDEROT_ERR(
+			"Could not find session based on rotation work item\n");
+		return -EINVAL;
+	}
+
+	if (mgr->single_hw || mgr->queue_count == 1) {
+		/* one hw serves every priority, keep a single commit queue */
+		wb_idx = min_t(u32, item->wb_idx, mgr->queue_count - 1);
+		queue = mgr->commitq;
+	} else {
+		wb_idx = sde_rotator_select_queue(mgr, entry, perf);
+		queue = &mgr->commitq[wb_idx];
 	}
 
 	entry->doneq = &mgr->doneq[wb_idx];
-	entry->commitq = &mgr->commitq[wb_idx];
-	queue = mgr->commitq;
+	entry->commitq = queue;
+	entry->perf = perf;
 
 	if (!queue->hw) {
 		hw = mgr->ops_hw_alloc(mgr, pipe_idx, wb_idx);
 		if (IS_ERR_OR_NULL(hw)) {
 			SDEROT_ERR("fail to allocate hw\n");
-			ret = PTR_ERR(hw);
-		} else {
-			queue->hw = hw;
+			return hw ? PTR_ERR(hw) : -ENOMEM;
 		}
+		queue->hw = hw;
 	}
 
-	if (queue->hw) {
-		entry->commitq = queue;
-		queue->hw->pending_count++;
-	}
-
-	perf = sde_rotator_find_session(private, item->session_id);
-	if (!perf) {
-		SDEROT_ERR(
-			"Could not find session based on rotation work item\n");
-		return -EINVAL;
-	}
-
-	entry->perf = perf;
+	queue->hw->pending_count++;
+	queue->pending_load += sde_rotator_entry_load(entry);
 	perf->last_wb_idx = wb_idx;
+	perf->assigned_count++;
 
-	return ret;
+	SDEROT_EVTLOG(item->session_id, item->wb_idx, wb_idx,
+			queue->pending_load);
+
+	return 0;
 }
 
 static void sde_rotator_unassign_queue(struct sde_rot_mgr *mgr,
 	struct sde_rot_entry *entry)
 {
 	struct sde_rot_queue *queue = entry->commitq;
+	u64 load;
 
 	if (!queue)
 		return;
@@ -1265,15 +1317,22 @@ static void sde_rotator_unassign_queue(struct sde_rot_mgr *mgr,
 	entry->commitq = NULL;
 	entry->doneq = NULL;
 
+	if (entry->perf && entry->perf->assigned_count)
+		entry->perf->assigned_count--;
+
 	if (!queue->hw) {
 		SDEROT_ERR("entry assigned a queue with no hw\n");
 		return;
 	}
 
+	load = sde_rotator_entry_load(entry);
+	queue->pending_load -= min(load, queue->pending_load);
+
 	queue->hw->pending_count--;
 	if (queue->hw->pending_count == 0) {
 		mgr->ops_hw_free(mgr, queue->hw);
 		queue->hw = NULL;
+		queue->pending_load = 0;
 	}
 }
 
@@ -232,6 +232,7 @@ struct sde_rot_queue {
 	struct task_struct *rot_thread;
 	struct sde_rot_timeline *timeline;
 	struct sde_rot_hw_resource *hw;
+	u64 pending_load; /* source pixels of entries assigned to this queue */
 };
 
 struct sde_rot_queue_v1 {
@@ -332,6 +333,7 @@ struct sde_rot_perf {
 	struct mutex work_dis_lock;
 	u32 *work_distribution;
 	int last_wb_idx; /* last known wb index, used when above count is 0 */
+	u32 assigned_count; /* entries holding a queue assigned at last_wb_idx */
 	u32 rdot_limit;
 	u32 wrot_limit;
 };
@@ -375,6 +377,8 @@ struct sde_rot_bus_data_type {
  * @queue_count: number of hardware queue/unit available
  * @commitq: array of rotator commit queue corresponding to hardware queue
  * @doneq: array of rotator done queue corresponding to hardware queue
+ * @single_hw: true if the hardware can't run queues concurrently, in which
+ *	case all commit queues share the hw resource of the first one
  * @file_list: list of all sessions managed by rotator manager
  * @pending_close_bw_vote: bandwidth of closed sessions with pending work
  * @minimum_bw_vote: minimum bandwidth required for current use case
@@ -413,6 +417,7 @@ struct sde_rot_mgr {
 	int queue_count;
 	struct sde_rot_queue *commitq;
 	struct sde_rot_queue *doneq;
+	bool single_hw;
 
 	/*
 	 * managing all the open file sessions to bw calculations,
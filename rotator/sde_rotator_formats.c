@@ -3,6 +3,8 @@
  * Copyright (c) 2012, 2015-2019, The Linux Foundation. All rights reserved.
  */
 
+#include <linux/hash.h>
+#include <linux/mutex.h>
 #include <media/msm_sde_rotator.h>
 
 #include "sde_rotator_formats.h"
@@ -779,38 +781,91 @@ static struct sde_mdp_format_params sde_mdp_format_map[] = {
 		SDE_MDP_COMPRESS_NONE),
 };
 
+/*
+ * Open addressed format -> format parameter table, populated once from
+ * sde_mdp_format_map and sde_mdp_format_ubwc_map. Must be larger than the
+ * total number of map entries.
+ */
+#define SDE_ROT_FORMAT_HASH_BITS	8
+#define SDE_ROT_FORMAT_HASH_SIZE	(1 << SDE_ROT_FORMAT_HASH_BITS)
+
+static struct sde_mdp_format_params
+		*sde_rot_format_hash[SDE_ROT_FORMAT_HASH_SIZE];
+
+static DEFINE_MUTEX(sde_rot_format_hash_lock);
+static bool sde_rot_format_hash_ready;
+
+static bool _sde_rot_format_hash_add(struct sde_mdp_format_params *fmt)
+{
+	u32 key, probe;
+	struct sde_mdp_format_params **entry;
+
+	key = hash_32(fmt->format, SDE_ROT_FORMAT_HASH_BITS);
+	for (probe = 0; probe < SDE_ROT_FORMAT_HASH_SIZE; probe++) {
+		entry = &sde_rot_format_hash[(key + probe) &
+				(SDE_ROT_FORMAT_HASH_SIZE - 1)];
+		if (!*entry) {
+			*entry = fmt;
+			return true;
+		}
+
+		/* keep first match, as the linear scan did */
+		if ((*entry)->format == fmt->format)
+			return true;
+	}
+
+	return false;
+}
+
+static void _sde_rot_format_hash_init(void)
+{
+	int i;
+
+	mutex_lock(&sde_rot_format_hash_lock);
+	if (sde_rot_format_hash_ready)
+		goto exit;
+
+	for (i = 0; i < ARRAY_SIZE(sde_mdp_format_map); i++)
+		if (WARN_ON(!_sde_rot_format_hash_add(
+				&sde_mdp_format_map[i])))
+			goto exit;
+
+	for (i = 0; i < ARRAY_SIZE(sde_mdp_format_ubwc_map); i++)
+		if (WARN_ON(!_sde_rot_format_hash_add(
+				&sde_mdp_format_ubwc_map[i].mdp_format)))
+			goto exit;
+
+	/* publish the table to lock-free readers */
+	smp_store_release(&sde_rot_format_hash_ready, true);
+exit:
+	mutex_unlock(&sde_rot_format_hash_lock);
+}
+
 /*
  * sde_get_format_params - return format parameter of the given format
  * @format: format to lookup
  */
 struct sde_mdp_format_params *sde_get_format_params(u32 format)
 {
-	struct sde_mdp_format_params *fmt = NULL;
-	int i;
-	bool fmt_found = false;
-
-	for (i = 0; i < ARRAY_SIZE(sde_mdp_format_map); i++) {
-		fmt = &sde_mdp_format_map[i];
-		if (format == fmt->format) {
-			fmt_found = true;
+	struct sde_mdp_format_params *fmt;
+	u32 key, probe;
+
+	if (!smp_load_acquire(&sde_rot_format_hash_ready))
+		_sde_rot_format_hash_init();
+
+	key = hash_32(format, SDE_ROT_FORMAT_HASH_BITS);
+	for (probe = 0; probe < SDE_ROT_FORMAT_HASH_SIZE; probe++) {
+		fmt = sde_rot_format_hash[(key + probe) &
+				(SDE_ROT_FORMAT_HASH_SIZE - 1)];
+		/* If format not supported than return NULL */
+		if (!fmt)
 			break;
-		}
-	}
 
-	if (!fmt_found) {
-		for (i = 0; i < ARRAY_SIZE(sde_mdp_format_ubwc_map); i++) {
-			fmt = &sde_mdp_format_ubwc_map[i].mdp_format;
-			if (format == fmt->format) {
-				fmt_found = true;
-				break;
-			}
-		}
+		if (fmt->format == format)
+			return fmt;
 	}
-	/* If format not supported than return NULL */
-	if (!fmt_found)
-		fmt = NULL;
 
-	return fmt;
+	return NULL;
 }
 
 /*
@@ -3978,6 +3978,9 @@ int sde_rotator_r3_init(struct sde_rot_mgr *mgr)
 	if (ret)
 		goto error_parse_dt;
 
+	/* without regdma all queues program the same registers directly */
+	mgr->single_hw = (rot->mode == ROT_REGDMA_OFF);
+
 	rot->irq_num = -EINVAL;
 	atomic_set(&rot->irq_enabled, 0);
 
@@ -301,10 +301,74 @@ done:
 	return rc;
 }
 
+/*
+ * LRU of a5x ubwc/tile plane sizes keyed by pixel format and dimensions, so
+ * the alignment math is not redone for every rotation request of a stream.
+ */
+#define SDE_MDP_PLANE_SIZES_CACHE_SIZE	8
+
+struct sde_mdp_plane_sizes_cache_entry {
+	struct list_head list;
+	u32 format;
+	u32 width;
+	u32 height;
+	struct sde_mdp_plane_sizes ps;
+};
+
+static struct sde_mdp_plane_sizes_cache_entry
+		sde_mdp_plane_sizes_cache[SDE_MDP_PLANE_SIZES_CACHE_SIZE];
+static LIST_HEAD(sde_mdp_plane_sizes_lru);
+static u32 sde_mdp_plane_sizes_cache_count;
+static DEFINE_SPINLOCK(sde_mdp_plane_sizes_lock);
+
+static bool sde_mdp_plane_sizes_cache_get(u32 format, u32 w, u32 h,
+	struct sde_mdp_plane_sizes *ps)
+{
+	struct sde_mdp_plane_sizes_cache_entry *entry;
+	bool found = false;
+
+	spin_lock(&sde_mdp_plane_sizes_lock);
+	list_for_each_entry(entry, &sde_mdp_plane_sizes_lru, list) {
+		if (entry->format == format && entry->width == w &&
+				entry->height == h) {
+			list_move(&entry->list, &sde_mdp_plane_sizes_lru);
+			*ps = entry->ps;
+			found = true;
+			break;
+		}
+	}
+	spin_unlock(&sde_mdp_plane_sizes_lock);
+
+	return found;
+}
+
+static void sde_mdp_plane_sizes_cache_put(u32 format, u32 w, u32 h,
+	struct sde_mdp_plane_sizes *ps)
+{
+	struct sde_mdp_plane_sizes_cache_entry *entry;
+
+	spin_lock(&sde_mdp_plane_sizes_lock);
+	if (sde_mdp_plane_sizes_cache_count < SDE_MDP_PLANE_SIZES_CACHE_SIZE) {
+		entry = &sde_mdp_plane_sizes_cache[
+				sde_mdp_plane_sizes_cache_count++];
+		list_add(&entry->list, &sde_mdp_plane_sizes_lru);
+	} else {
+		entry = list_last_entry(&sde_mdp_plane_sizes_lru,
+				struct sde_mdp_plane_sizes_cache_entry, list);
+		list_move(&entry->list, &sde_mdp_plane_sizes_lru);
+	}
+	entry->format = format;
+	entry->width = w;
+	entry->height = h;
+	entry->ps = *ps;
+	spin_unlock(&sde_mdp_plane_sizes_lock);
+}
+
 int sde_mdp_get_plane_sizes(struct sde_mdp_format_params *fmt, u32 w, u32 h,
 	struct sde_mdp_plane_sizes *ps, u32 bwc_mode, bool rotation)
 {
 	int i, rc = 0;
+	bool cache = false;
 	u32 bpp;
 
 	if (ps == NULL)
@@ -317,7 +381,11 @@ int sde_mdp_get_plane_sizes(struct sde_mdp_format_params *fmt, u32 w, u32 h,
 	memset(ps, 0, sizeof(struct sde_mdp_plane_sizes));
 
 	if (sde_mdp_is_tilea5x_format(fmt)) {
+		if (sde_mdp_plane_sizes_cache_get(fmt->format, w, h, ps))
+			return 0;
+
 		rc = sde_mdp_get_a5x_plane_size(fmt, w, h, ps);
+		cache = !rc;
 	} else if (bwc_mode) {
 		u32 height, meta_size;
 
@@ -439,6 +507,9 @@ int sde_mdp_get_plane_sizes(struct sde_mdp_format_params *fmt, u32 w, u32 h,
 	for (i = 0; i < SDE_ROT_MAX_PLANES; i++)
 		ps->total_size += ps->plane_size[i];
 
+	if (cache)
+		sde_mdp_plane_sizes_cache_put(fmt->format, w, h, ps);
+
 	return rc;
 }
 